@@ -0,0 +1,198 @@
+// Atomic libcalls, the M0+ has no LDREX/STREX, so GCC turns every atomic read-modify-write and every 8 byte
+// atomic access into a call to one of the functions below. newlib-nano has none of them.
+//
+// Each operation masks interrupts on its core and takes one of SPINLOCK_ATOMIC_STRIPES SIO spinlocks, picked by a
+// hash of the address, so atomics on unrelated variables mostly take different locks. The hash is taken over the
+// 8 byte granule, so all accesses to the same variable, whatever their size, agree on the lock.
+//
+// GCC would otherwise inline aligned atomic loads and stores of up to 4 bytes as single bus transfers, and such a
+// store from one core is lost when it lands between the read and the write of a locked read-modify-write on the
+// other core. The Makefile builds with -fno-inline-atomics, so loads and stores come here and take the same lock.
+// Every operation is sequentially consistent, the memory order argument is ignored.
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifdef HOST_MODEL
+#include "atomicModel.h" // Spinlocks are routed to the host-side model, the cores are host threads
+#else
+#include "spinlock_rp2040.h"
+#endif
+
+static inline uint32_t atomicLock(const volatile void *ptr)
+{
+    // Fibonacci hash, the top bits spread strided arrays over all stripes
+    return SPINLOCK_ATOMIC((((uint32_t)(uintptr_t)ptr >> 3) * 0x9e3779b1u) >> 28);
+}
+
+// Release the locks at startup, the SIO is not reset along with the cores and a warm reset may leave one taken.
+// Runs ahead of the constructors without a priority, which may already use atomics.
+__attribute__((constructor(101))) static void atomicInit(void)
+{
+    for (uint32_t i = 0; i < SPINLOCK_ATOMIC_STRIPES; ++i)
+        SIO_SPINLOCK(SPINLOCK_ATOMIC(i)) = 0;
+}
+
+// The builtins cannot be defined under their own names in C, so the functions get those as assembler labels
+#define ATOMIC_LOCKED(ptr, body)                                                \
+    uint32_t lock = atomicLock(ptr);                                            \
+    uint32_t primask = spinLock(lock);                                          \
+    body                                                                        \
+    spinUnlock(lock, primask);
+
+#define ATOMIC_SIZED(N, T)                                                                                          \
+    T atomicLoad##N(const volatile void *ptr, int model) __asm__("__atomic_load_" #N);                              \
+    T atomicLoad##N(const volatile void *ptr, int model)                                                            \
+    {                                                                                                               \
+        (void)model;                                                                                                \
+        T result;                                                                                                   \
+        ATOMIC_LOCKED(ptr, result = *(const volatile T *)ptr;)                                                      \
+        return result;                                                                                              \
+    }                                                                                                               \
+    void atomicStore##N(volatile void *ptr, T val, int model) __asm__("__atomic_store_" #N);                        \
+    void atomicStore##N(volatile void *ptr, T val, int model)                                                       \
+    {                                                                                                               \
+        (void)model;                                                                                                \
+        ATOMIC_LOCKED(ptr, *(volatile T *)ptr = val;)                                                               \
+    }                                                                                                               \
+    T atomicExchange##N(volatile void *ptr, T val, int model) __asm__("__atomic_exchange_" #N);                     \
+    T atomicExchange##N(volatile void *ptr, T val, int model)                                                       \
+    {                                                                                                               \
+        (void)model;                                                                                                \
+        T old;                                                                                                      \
+        ATOMIC_LOCKED(ptr, old = *(volatile T *)ptr; *(volatile T *)ptr = val;)                                     \
+        return old;                                                                                                 \
+    }                                                                                                               \
+    bool atomicCompareExchange##N(volatile void *ptr, void *expected, T desired, bool weak, int success,            \
+                                  int failure) __asm__("__atomic_compare_exchange_" #N);                            \
+    bool atomicCompareExchange##N(volatile void *ptr, void *expected, T desired, bool weak, int success,            \
+                                  int failure)                                                                      \
+    {                                                                                                               \
+        (void)weak; (void)success; (void)failure;                                                                   \
+        bool equal;                                                                                                 \
+        ATOMIC_LOCKED(ptr,                                                                                          \
+            T old = *(volatile T *)ptr;                                                                             \
+            equal = (old == *(T *)expected);                                                                        \
+            if (equal)                                                                                              \
+                *(volatile T *)ptr = desired;                                                                       \
+            else                                                                                                    \
+                *(T *)expected = old;)                                                                              \
+        return equal;                                                                                               \
+    }                                                                                                               \
+    T syncValCompareAndSwap##N(volatile void *ptr, T oldVal, T newVal) __asm__("__sync_val_compare_and_swap_" #N);  \
+    T syncValCompareAndSwap##N(volatile void *ptr, T oldVal, T newVal)                                              \
+    {                                                                                                               \
+        T old;                                                                                                      \
+        ATOMIC_LOCKED(ptr,                                                                                          \
+            old = *(volatile T *)ptr;                                                                               \
+            if (old == oldVal)                                                                                      \
+                *(volatile T *)ptr = newVal;)                                                                       \
+        return old;                                                                                                 \
+    }                                                                                                               \
+    bool syncBoolCompareAndSwap##N(volatile void *ptr, T oldVal, T newVal) __asm__("__sync_bool_compare_and_swap_" #N); \
+    bool syncBoolCompareAndSwap##N(volatile void *ptr, T oldVal, T newVal)                                          \
+    {                                                                                                               \
+        return syncValCompareAndSwap##N(ptr, oldVal, newVal) == oldVal;                                             \
+    }                                                                                                               \
+    T syncLockTestAndSet##N(volatile void *ptr, T val) __asm__("__sync_lock_test_and_set_" #N);                     \
+    T syncLockTestAndSet##N(volatile void *ptr, T val)                                                              \
+    {                                                                                                               \
+        return atomicExchange##N(ptr, val, __ATOMIC_SEQ_CST);                                                       \
+    }                                                                                                               \
+    void syncLockRelease##N(volatile void *ptr) __asm__("__sync_lock_release_" #N);                                 \
+    void syncLockRelease##N(volatile void *ptr)                                                                     \
+    {                                                                                                               \
+        atomicStore##N(ptr, 0, __ATOMIC_SEQ_CST);                                                                   \
+    }
+
+// fetch_OP returns the old value, OP_fetch the new one, the __sync variants are the same operations
+#define ATOMIC_OP(N, T, name, syncName, expr)                                                                       \
+    T atomicFetch##name##N(volatile void *ptr, T val, int model) __asm__("__atomic_fetch_" #syncName "_" #N);       \
+    T atomicFetch##name##N(volatile void *ptr, T val, int model)                                                    \
+    {                                                                                                               \
+        (void)model;                                                                                                \
+        T old;                                                                                                      \
+        ATOMIC_LOCKED(ptr, old = *(volatile T *)ptr; *(volatile T *)ptr = (T)(expr);)                               \
+        return old;                                                                                                 \
+    }                                                                                                               \
+    T atomic##name##Fetch##N(volatile void *ptr, T val, int model) __asm__("__atomic_" #syncName "_fetch_" #N);     \
+    T atomic##name##Fetch##N(volatile void *ptr, T val, int model)                                                  \
+    {                                                                                                               \
+        T old = atomicFetch##name##N(ptr, val, model);                                                              \
+        return (T)(expr);                                                                                           \
+    }                                                                                                               \
+    T syncFetchAnd##name##N(volatile void *ptr, T val) __asm__("__sync_fetch_and_" #syncName "_" #N);               \
+    T syncFetchAnd##name##N(volatile void *ptr, T val)                                                              \
+    {                                                                                                               \
+        return atomicFetch##name##N(ptr, val, __ATOMIC_SEQ_CST);                                                    \
+    }                                                                                                               \
+    T sync##name##AndFetch##N(volatile void *ptr, T val) __asm__("__sync_" #syncName "_and_fetch_" #N);             \
+    T sync##name##AndFetch##N(volatile void *ptr, T val)                                                            \
+    {                                                                                                               \
+        return atomic##name##Fetch##N(ptr, val, __ATOMIC_SEQ_CST);                                                  \
+    }
+
+#define ATOMIC_ALL(N, T)                                \
+    ATOMIC_SIZED(N, T)                                  \
+    ATOMIC_OP(N, T, Add, add, old + val)                \
+    ATOMIC_OP(N, T, Sub, sub, old - val)                \
+    ATOMIC_OP(N, T, And, and, old & val)                \
+    ATOMIC_OP(N, T, Or, or, old | val)                  \
+    ATOMIC_OP(N, T, Xor, xor, old ^ val)                \
+    ATOMIC_OP(N, T, Nand, nand, ~(old & val))
+
+ATOMIC_ALL(1, uint8_t)
+ATOMIC_ALL(2, uint16_t)
+ATOMIC_ALL(4, uint32_t)
+ATOMIC_ALL(8, uint64_t)
+
+// Objects of any other size, e.g. a std::atomic of a struct, are copied under the lock of their address
+void atomicLoad(size_t size, const volatile void *ptr, void *ret, int model) __asm__("__atomic_load");
+void atomicLoad(size_t size, const volatile void *ptr, void *ret, int model)
+{
+    (void)model;
+    ATOMIC_LOCKED(ptr, memcpy(ret, (const void *)ptr, size);)
+}
+
+void atomicStore(size_t size, volatile void *ptr, void *val, int model) __asm__("__atomic_store");
+void atomicStore(size_t size, volatile void *ptr, void *val, int model)
+{
+    (void)model;
+    ATOMIC_LOCKED(ptr, memcpy((void *)ptr, val, size);)
+}
+
+void atomicExchange(size_t size, volatile void *ptr, void *val, void *ret, int model) __asm__("__atomic_exchange");
+void atomicExchange(size_t size, volatile void *ptr, void *val, void *ret, int model)
+{
+    (void)model;
+    ATOMIC_LOCKED(ptr,
+        memcpy(ret, (const void *)ptr, size);
+        memcpy((void *)ptr, val, size);)
+}
+
+bool atomicCompareExchange(size_t size, volatile void *ptr, void *expected, void *desired, int success,
+                           int failure) __asm__("__atomic_compare_exchange");
+bool atomicCompareExchange(size_t size, volatile void *ptr, void *expected, void *desired, int success, int failure)
+{
+    (void)success; (void)failure;
+    bool equal;
+    ATOMIC_LOCKED(ptr,
+        equal = !memcmp((const void *)ptr, expected, size);
+        if (equal)
+            memcpy((void *)ptr, desired, size);
+        else
+            memcpy(expected, (const void *)ptr, size);)
+    return equal;
+}
+
+// Full barrier
+void syncSynchronize(void) __asm__("__sync_synchronize");
+void syncSynchronize(void)
+{
+#ifdef HOST_MODEL
+    __sync_synchronize();
+#else
+    asm volatile ("dmb" ::: "memory");
+#endif
+}
@@ -0,0 +1,88 @@
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <chrono>
+
+#include "atomicModel.h"
+
+// Built with -fno-inline-atomics like the firmware, so every __atomic builtin below is a call into atomic_rp2040.c
+// running on the spinlock model, with host threads as the cores. Core 0 stops in the middle of a read-modify-write,
+// holding the lock between its read and its write, while core 1 stores to the same variable. The store has to wait
+// for the lock: one that lands in between is undone by the write and lost.
+static int failures;
+
+static void check(const char *name, bool pass)
+{
+    failures += !pass;
+    std::cout << std::left << std::setw(40) << name << (pass ? "ok" : "FAIL") << std::endl;
+}
+
+static uint32_t atomicLocksTaken()
+{
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < SPINLOCK_ATOMIC_STRIPES; ++i)
+        count += spinLockCount(SPINLOCK_ATOMIC(i));
+    return count;
+}
+
+// The stripe atomic_rp2040.c picks for ptr, the lock taken by one read-modify-write on it
+template <typename W>
+static uint32_t atomicLockOf(W *ptr)
+{
+    uint32_t before[SPINLOCK_ATOMIC_STRIPES];
+    for (uint32_t i = 0; i < SPINLOCK_ATOMIC_STRIPES; ++i)
+        before[i] = spinLockCount(SPINLOCK_ATOMIC(i));
+    __atomic_fetch_xor(ptr, 0, __ATOMIC_SEQ_CST);
+    for (uint32_t i = 0; i < SPINLOCK_ATOMIC_STRIPES; ++i)
+        if (spinLockCount(SPINLOCK_ATOMIC(i)) != before[i])
+            return SPINLOCK_ATOMIC(i);
+    return 0;
+}
+
+// Core 0 flips bit 0 of word by hand under its lock while core 1 stores value at tag, both in the same variable.
+// True if the store waited for the flip and survived it.
+template <typename T, typename W>
+static bool storeWaitsForRmw(T *tag, W *word, T value)
+{
+    uint32_t lock = atomicLockOf(word);
+    uint32_t primask = spinLock(lock);
+    W old = *(volatile W *)word;
+    T tagBefore = *(volatile T *)tag;
+
+    std::thread core1([=] { __atomic_store_n(tag, value, __ATOMIC_SEQ_CST); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    bool waited = *(volatile T *)tag == tagBefore;
+
+    *(volatile W *)word = old ^ 1;
+    spinUnlock(lock, primask);
+    core1.join();
+    return lock && waited && __atomic_load_n(tag, __ATOMIC_SEQ_CST) == value;
+}
+
+int main()
+{
+    alignas(8) static uint32_t word;
+    uint32_t before = atomicLocksTaken();
+    __atomic_store_n(&word, 1, __ATOMIC_SEQ_CST);
+    check("4 byte store takes a lock", atomicLocksTaken() == before + 1);
+    before = atomicLocksTaken();
+    (void)__atomic_load_n(&word, __ATOMIC_SEQ_CST);
+    check("4 byte load takes a lock", atomicLocksTaken() == before + 1);
+
+    word = 0;
+    check("4 byte store vs 4 byte flip", storeWaitsForRmw(&word, &word, 0x12340000u));
+
+    // Different sizes in the same 8 byte granule have to agree on the lock, the top byte on a little endian host
+    word = 0;
+    check("1 byte store vs 4 byte flip", storeWaitsForRmw((uint8_t *)&word + 3, &word, (uint8_t)0x5a));
+
+    alignas(8) static uint64_t doubleWord;
+    check("8 byte store vs 8 byte flip", storeWaitsForRmw(&doubleWord, &doubleWord, (uint64_t)0x1234567800000000ull));
+    doubleWord = 0;
+    check("2 byte store vs 8 byte flip", storeWaitsForRmw((uint16_t *)&doubleWord + 3, &doubleWord, (uint16_t)0xa5a5));
+    check("4 byte store vs 8 byte flip", storeWaitsForRmw((uint32_t *)&doubleWord + 1, &doubleWord, 0xdeadbeefu));
+
+    if (failures)
+        std::cout << failures << " check(s) failed. Exiting ..." << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,47 @@
+#include <mutex>
+#include <thread>
+
+#include "atomicModel.h"
+
+// The claim bits of the 32 SIO spinlocks. The host mutex only stands in for the single cycle bus access, the lock
+// itself is the bit, which a thread spins on like a core does.
+static std::mutex sioBus;
+static bool claimed[32];
+static uint32_t taken[32];
+
+spinlockMmio::operator uint32_t() const
+{
+    std::lock_guard<std::mutex> guard(sioBus);
+    if (claimed[lock])
+        return 0;
+    claimed[lock] = true;
+    ++taken[lock];
+    return 1u << lock;
+}
+
+spinlockMmio &spinlockMmio::operator=(uint32_t value)
+{
+    (void)value;
+    std::lock_guard<std::mutex> guard(sioBus);
+    claimed[lock] = false;
+    return *this;
+}
+
+uint32_t spinLock(uint32_t lock)
+{
+    while (!SIO_SPINLOCK(lock))
+        std::this_thread::yield();
+    return 0;
+}
+
+void spinUnlock(uint32_t lock, uint32_t primask)
+{
+    (void)primask;
+    SIO_SPINLOCK(lock) = 0;
+}
+
+uint32_t spinLockCount(uint32_t lock)
+{
+    std::lock_guard<std::mutex> guard(sioBus);
+    return taken[lock];
+}
@@ -0,0 +1,27 @@
+#ifndef ATOMIC_MODEL_H
+#define ATOMIC_MODEL_H
+
+#include <cstdint>
+
+// SIO spinlock proxy routing every lock access of atomic_rp2040.c to the model in atomicModel.cpp. Host threads
+// stand in for the two cores, a read claims the lock and returns nonzero on success, a write releases it.
+struct spinlockMmio
+{
+    uint32_t lock;
+    operator uint32_t() const;
+    spinlockMmio &operator=(uint32_t value);
+};
+
+// Lock assignment as in spinlock_rp2040.h
+#define SIO_SPINLOCK(n)             (spinlockMmio{(n)})
+#define SPINLOCK_ATOMIC(stripe)     (16 + (stripe))
+#define SPINLOCK_ATOMIC_STRIPES     (16)
+
+// There are no interrupts to mask on the host, the returned state is a dummy
+uint32_t spinLock(uint32_t lock);
+void spinUnlock(uint32_t lock, uint32_t primask);
+
+// Number of times a lock was taken, to tell a libcall from an inlined access
+uint32_t spinLockCount(uint32_t lock);
+
+#endif
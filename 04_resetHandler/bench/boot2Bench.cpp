@@ -0,0 +1,122 @@
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+
+#include "ssiModel.h"
+#include "../bootTrace.h"
+
+// Boot stage 2 entry point, compiled from one of the boot2 sources with -DHOST_MODEL
+extern void bootStage2(void);
+
+// Model instance the register proxies talk to
+ssiModel *hostModel;
+
+#ifdef BOOT_TRACE
+// Boot phase timeline written by the boot2 probes, dumped with --trace=<file>
+bootTraceBuffer bootTraceBuf;
+#endif
+
+// Print each distinct message only once, the flash model reports per clock
+static void printLog(const char *who, const std::vector<std::string> &log, size_t from = 0)
+{
+    std::set<std::string> seen;
+    for (size_t i = from; i < log.size(); ++i)
+    {
+        if (seen.insert(log[i]).second)
+            std::cout << "    " << who << ": " << log[i] << std::endl;
+    }
+}
+
+// Describe the bus phases of the last transaction as the flash decoded them
+static std::string describe(const flashModel::transaction &tr)
+{
+    std::ostringstream str;
+    str << std::hex << std::uppercase << std::setfill('0');
+    if (tr.cmd >= 0)
+        str << "cmd " << std::setw(2) << tr.cmd << "h, ";
+    else
+        str << "no cmd (continuous), ";
+    str << "addr x" << std::dec << tr.addrLanes << ", ";
+    if (tr.mode >= 0)
+        str << "mode " << std::hex << std::setw(2) << tr.mode << "h x4, ";
+    str << std::dec << "dummy " << tr.dummyCycles << ", data x" << tr.dataLanes;
+    return str.str();
+}
+
+int main(int argc, char *argv[])
+{
+    const char *name = (argc > 1) ? argv[1] : "boot2";
+    bool qe = true;
+    std::string tracePath;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--qe=0")
+            qe = false;
+        else if (arg.rfind("--trace=", 0) == 0)
+            tracePath = arg.substr(8);
+    }
+    ssiModel model(qe);
+    hostModel = &model;
+
+    // Run boot2 until it jumps to the resetHandler
+    try
+    {
+        bootStage2();
+    }
+    catch (const boot2Handoff &)
+    {
+    }
+
+#ifdef BOOT_TRACE
+    if (!tracePath.empty())
+    {
+        std::ofstream traceFile(tracePath, std::ios::binary);
+        traceFile.write((const char *)&bootTraceBuf, sizeof(bootTraceBuf));
+    }
+#endif
+
+    std::cout << name << (qe ? "" : " (QE = 0 at power up)") << std::endl;
+    printLog("ssi", model.log());
+    printLog("flash", model.flash.log());
+    if (model.vtor != 0x10000100)
+        std::cout << "    boot2: VTOR = 0x" << std::hex << model.vtor << std::dec << ", expected 0x10000100" << std::endl;
+
+    size_t bootMessages = model.flash.log().size();
+
+    // Fetch through XIP and check every word against the flash content
+    int errors = 0, wordCycles = 0, lineCycles = 0;
+    uint32_t addrs[] = {0x10000100, 0x10000104, 0x10000108, 0x10001234 & ~7u, 0x100ffff8};
+    for (uint32_t addr : addrs)
+    {
+        uint32_t data[2];
+        wordCycles = model.xipRead(addr, 1, data);
+        lineCycles = model.xipRead(addr, 2, data);
+        for (int i = 0; i < 2; ++i)
+        {
+            uint32_t expected = 0;
+            for (int b = 3; b >= 0; --b)
+                expected = (expected << 8) | model.flash.byteAt(addr + 4 * i + b);
+            if (data[i] != expected)
+                errors++;
+        }
+    }
+    printLog("flash", model.flash.log(), bootMessages);
+
+    std::cout << "    XIP read: " << describe(model.flash.lastTransaction()) << std::endl;
+    if (errors)
+        std::cout << "    XIP read: " << errors << " word(s) did not match the flash content" << std::endl;
+
+    // An 8 byte cache line is refilled with one 2 word transfer
+    uint32_t baud = model.baudr ? model.baudr : 1;
+    std::cout << "    SCK cycles per 32-bit fetch:  " << std::setw(4) << wordCycles
+              << "    clk_sys cycles at BAUDR " << baud << ": " << std::setw(4) << wordCycles * baud
+              << ", at BAUDR 2: " << std::setw(4) << wordCycles * 2 << std::endl;
+    std::cout << "    SCK cycles per cache line:    " << std::setw(4) << lineCycles
+              << "    clk_sys cycles at BAUDR " << baud << ": " << std::setw(4) << lineCycles * baud
+              << ", at BAUDR 2: " << std::setw(4) << lineCycles * 2 << std::endl;
+
+    return errors ? 1 : 0;
+}
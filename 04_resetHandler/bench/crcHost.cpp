@@ -0,0 +1,171 @@
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <vector>
+
+#include "../crc_rp2040.h"
+#include "../dma_rp2040.h"
+#include "../tools/crc32Mpeg2.h"
+
+// Host model of the DMA channel and sniffer behind crc_rp2040.c. Transfers run to completion inside dmaStart and the
+// sniffer folds in every item it sees bit by bit, independent of the table driven tools/crc32Mpeg2.h it is checked
+// against. Both ends have to agree on every vector for a checksum patched in on the host to pass on the device.
+static bool sniffClaimed, sniffEnabled, sniffBswap;
+static uint32_t sniffChannel, sniffCalc, sniffData;
+static uint32_t sniffedBytes;
+static int32_t claimedChannel = -1;
+
+int32_t dmaClaim(void)
+{
+    claimedChannel = 0;
+    return claimedChannel;
+}
+
+void dmaRelease(uint32_t channel)
+{
+    (void)channel;
+    claimedChannel = -1;
+}
+
+bool dmaBusy(uint32_t channel)
+{
+    (void)channel;
+    return false;
+}
+
+void dmaWait(uint32_t channel)
+{
+    (void)channel;
+}
+
+bool dmaSniffClaim(void)
+{
+    bool free = !sniffClaimed;
+    sniffClaimed = true;
+    return free;
+}
+
+void dmaSniffRelease(void)
+{
+    sniffEnabled = false;
+    sniffClaimed = false;
+}
+
+void dmaSniffStart(uint32_t channel, uint32_t calc, bool bswap, uint32_t seed)
+{
+    sniffEnabled = true;
+    sniffChannel = channel;
+    sniffCalc = calc;
+    sniffBswap = bswap;
+    sniffData = seed;
+}
+
+uint32_t dmaSniffResult(void)
+{
+    return sniffData;
+}
+
+// CRC-32 of the sniffer, most significant data bit first
+static void sniff(uint32_t value, uint32_t bits)
+{
+    for (uint32_t bit = bits; bit--;)
+    {
+        uint32_t in = ((value >> bit) ^ (sniffData >> 31)) & 1;
+        sniffData = (sniffData << 1) ^ (in ? 0x04c11db7 : 0);
+    }
+}
+
+void dmaStart(uint32_t channel, const volatile void *read, volatile void *write, uint32_t count, uint32_t ctrl,
+              dmaCallback callback, void *arg)
+{
+    (void)write;
+    uint32_t size = 1 << ((ctrl >> 2) & 3);
+    const volatile uint8_t *src = (const volatile uint8_t *)read;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        // The bus is little-endian, a narrow item sits in the low bits
+        uint32_t value = 0;
+        for (uint32_t byte = 0; byte < size; ++byte)
+            value |= (uint32_t)src[byte] << (8 * byte);
+        if (sniffBswap)
+            value = size == 4 ? __builtin_bswap32(value) : size == 2 ? __builtin_bswap16(value) : value;
+        if ((ctrl & DMA_SNIFF) && sniffEnabled && sniffChannel == channel && sniffCalc == DMA_SNIFF_CRC32)
+        {
+            sniff(value, 8 * size);
+            sniffedBytes += size;
+        }
+        if (ctrl & DMA_INCR_READ)
+            src += size;
+    }
+    if (callback)
+        callback(channel, arg);
+}
+
+static int failures;
+
+static void check(const char *name, bool pass)
+{
+    failures += !pass;
+    std::cout << std::left << std::setw(56) << name << (pass ? "ok" : "FAIL") << std::endl;
+}
+
+static void asyncDone(uint32_t crc, void *arg)
+{
+    *(uint32_t *)arg = crc;
+}
+
+int main()
+{
+    // Shared vectors, the catalogue check string first
+    check("\"123456789\" gives the check value 0x0376e6e7", crcCalculate(crc32Mpeg2::checkInput, sizeof(crc32Mpeg2::checkInput)) == 0x0376e6e7);
+
+    std::vector<uint8_t> data(4096 + 8);
+    uint32_t seed = 1;
+    for (uint8_t &byte : data)
+        byte = (seed = seed * 1664525 + 1013904223) >> 24;
+    std::vector<uint8_t> zeros(1024), ones(1024, 0xff);
+    check("1kB of zeros", crcCalculate(zeros.data(), zeros.size()) == crc32Mpeg2::calculate(zeros.data(), zeros.size()));
+    check("1kB of 0xff", crcCalculate(ones.data(), ones.size()) == crc32Mpeg2::calculate(ones.data(), ones.size()));
+
+    // Every start alignment against every length up to a few words, then long runs. The sniffer has to see all
+    // but the up to 3 bytes at either end.
+    bool agree = true, sniffed = true;
+    for (uint32_t offset = 0; offset < 8; ++offset)
+    {
+        for (uint32_t len = 0; len <= 4096; len = len < 64 ? len + 1 : len * 2 + 3)
+        {
+            sniffedBytes = 0;
+            agree &= crcCalculate(&data[offset], len) == crc32Mpeg2::calculate(&data[offset], len);
+            uint32_t head = std::min<uint32_t>(-(uintptr_t)&data[offset] & 3, len);
+            sniffed &= sniffedBytes == (len - head) / 4 * 4;
+        }
+    }
+    check("Random data at every alignment and length", agree);
+    check("Only the unaligned ends are done on the CPU", sniffed);
+
+    // A CRC continued over pieces equals the CRC of the whole
+    uint32_t crc = CRC_INIT;
+    for (uint32_t pos = 0, piece = 1; pos < 4096; pos += piece, piece = piece * 3 + 1)
+        crc = crcUpdate(crc, &data[pos], std::min<uint32_t>(piece, 4096 - pos));
+    check("crcUpdate over uneven pieces", crc == crc32Mpeg2::calculate(data.data(), 4096));
+
+    uint32_t asyncCrc = 0;
+    bool started = crcStart(CRC_INIT, &data[1], 3001, asyncDone, &asyncCrc);
+    check("crcStart hands the same CRC to its callback", started && asyncCrc == crc32Mpeg2::calculate(&data[1], 3001));
+    asyncCrc = 0;
+    started = crcStart(CRC_INIT, &data[1], 2, asyncDone, &asyncCrc);
+    check("crcStart without a whole word", started && asyncCrc == crc32Mpeg2::calculate(&data[1], 2));
+
+    // With the sniffer taken the blocking call falls back to the CPU and the other one refuses
+    dmaSniffClaim();
+    sniffedBytes = 0;
+    bool fallback = crcCalculate(data.data(), 1000) == crc32Mpeg2::calculate(data.data(), 1000) && !sniffedBytes;
+    fallback &= !crcStart(CRC_INIT, data.data(), 1000, asyncDone, &asyncCrc);
+    dmaSniffRelease();
+    check("Sniffer in use: CPU fallback, no start", fallback);
+    check("Sniffer released after every CRC", crcStart(CRC_INIT, data.data(), 8, asyncDone, &asyncCrc) && !sniffClaimed);
+
+    if (failures)
+        std::cout << failures << " check(s) failed. Exiting ..." << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,46 @@
+// On-target sniffer CRC benchmark, build with make benchTarget BENCH=crcSniff
+// and read the results with a debugger once benchDone is set. make crcHost checks the same code on the host.
+//
+// The catalogue check string has to give the value of tools/crc32Mpeg2.h. A block of .text is then checked where it
+// is in flash and again after copying it to SRAM, both CRCs have to agree. The rates are those of crcCalculate.
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../crc_rp2040.h"
+#include "../timer_rp2040.h"
+
+#define BLOCK_SIZE                  (16384)
+#define RUNS                        (16)
+
+volatile bool checkValueOk, flashSramOk;
+volatile uint32_t flashBytesPerSecond, sramBytesPerSecond;
+volatile bool benchDone;
+
+extern uint32_t _stext;
+
+static uint32_t buffer[BLOCK_SIZE / 4];
+
+static uint32_t measure(const void *data, uint32_t *crc)
+{
+    uint64_t start = readTime();
+    for (uint32_t run = 0; run < RUNS; ++run)
+        *crc = crcCalculate(data, BLOCK_SIZE);
+    return (uint64_t)BLOCK_SIZE * RUNS * 1000000 / (readTime() - start);
+}
+
+int main(void)
+{
+    static const uint8_t checkInput[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    checkValueOk = crcCalculate(checkInput, sizeof(checkInput)) == 0x0376e6e7;
+
+    uint32_t flashCrc, sramCrc;
+    memcpy(buffer, &_stext, BLOCK_SIZE);
+    flashBytesPerSecond = measure(&_stext, &flashCrc);
+    sramBytesPerSecond = measure(buffer, &sramCrc);
+    flashSramOk = flashCrc == sramCrc;
+
+    benchDone = true;
+    while (true)
+        asm volatile ("wfi");
+}
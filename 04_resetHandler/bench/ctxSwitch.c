@@ -0,0 +1,65 @@
+// On-target context switch benchmark, build with make benchTarget BENCH=ctxSwitch
+// and read the results with a debugger once benchDone is set.
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../sched_rp2040.h"
+
+#define ITERATIONS                  (100000)
+
+#ifndef CLK_SYS_HZ
+#define CLK_SYS_HZ                  (100000000)
+#endif
+
+// Results in clk_sys cycles, averaged over ITERATIONS
+volatile uint32_t yieldCycles;      // threadYield with no other thread ready, the bookkeeping alone
+volatile uint32_t switchCycles;     // threadYield handing over to another thread of the same priority
+volatile uint32_t ctxSwitchCycles;  // The difference, PendSV entry, register save and restore and exception return
+volatile bool benchDone;
+
+THREAD_STACK(benchStack, 256);
+THREAD_STACK(partnerStack, 128);
+static thread benchThread, partnerThread;
+
+static volatile uint32_t remaining;
+
+// Both threads take turns counting down, every threadYield switches to the other one
+static void pingPong(void *arg)
+{
+    (void)arg;
+    while (remaining)
+    {
+        --remaining;
+        threadYield();
+    }
+}
+
+static void bench(void *arg)
+{
+    (void)arg;
+
+    uint64_t start = readTime();
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+        threadYield();
+    uint64_t alone = readTime() - start;
+
+    remaining = ITERATIONS;
+    threadCreate(&partnerThread, pingPong, 0, partnerStack, 128, 1);
+    start = readTime();
+    pingPong(0);
+    uint64_t switched = readTime() - start;
+
+    yieldCycles = alone * (CLK_SYS_HZ / 1000000) / ITERATIONS;
+    switchCycles = switched * (CLK_SYS_HZ / 1000000) / ITERATIONS;
+    ctxSwitchCycles = switchCycles - yieldCycles;
+    benchDone = true;
+}
+
+int main(void)
+{
+    threadCreate(&benchThread, bench, 0, benchStack, 256, 1);
+    schedStart(); // main carries on as the idle thread
+
+    while (true)
+        asm volatile ("wfi");
+}
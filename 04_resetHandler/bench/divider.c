@@ -0,0 +1,182 @@
+// On-target integer division benchmark, build with make benchTarget BENCH=divider
+// and read the results with a debugger once benchDone is set.
+//
+// Every case divides a table of operands and reports the average clk_sys cycles per division, call included.
+// The default build measures the SIO divider of divider_rp2040.c, make clean and make benchTarget BENCH=divider
+// HWDIV=0 measures libgcc for comparison. divisionsOk checks the results against a shift and subtract reference.
+#include <stdint.h>
+#include <stdbool.h>
+
+// Define necessary register addresses
+// SysTick
+#define SYST_CSR                    (*(volatile uint32_t *) (0xe000e010))
+#define SYST_RVR                    (*(volatile uint32_t *) (0xe000e014))
+#define SYST_CVR                    (*(volatile uint32_t *) (0xe000e018))
+
+#define OPERANDS                    (64)
+
+enum
+{
+    DIV_U32,                // uint32_t / uint32_t
+    DIV_S32,                // int32_t / int32_t
+    DIV_MOD_U32,            // / and % of the same operands, a single __aeabi_uidivmod
+    DIV_U64_SMALL,          // uint64_t / uint64_t, both below 2^32
+    DIV_U64_BY_U16,         // uint64_t / divisor below 2^16
+    DIV_U64,                // uint64_t / uint64_t, wide divisor
+    DIV_S64,                // int64_t / int64_t
+    DIV_CASES
+};
+
+volatile uint32_t divCycles[DIV_CASES];
+volatile bool divisionsOk;
+volatile bool benchDone;
+
+// Operands go through volatile, so no division is folded at compile time
+static volatile uint64_t numerators[OPERANDS], denominators[OPERANDS];
+static volatile uint64_t sink;
+
+static inline uint32_t elapsed(uint32_t start)
+{
+    return (start - SYST_CVR) & 0xffffff; // SysTick counts down
+}
+
+// Plain shift and subtract, independent of whatever division got linked
+static uint64_t referenceDivide(uint64_t n, uint64_t d, uint64_t *rem)
+{
+    uint64_t quot = 0, r = 0;
+    for (int32_t bit = 63; bit >= 0; --bit)
+    {
+        r = r << 1 | ((n >> bit) & 1);
+        if (r >= d)
+        {
+            r -= d;
+            quot |= (uint64_t)1 << bit;
+        }
+    }
+    *rem = r;
+    return quot;
+}
+
+static uint64_t divide(uint32_t divCase, uint64_t n, uint64_t d)
+{
+    switch (divCase)
+    {
+    case DIV_U32:
+        return (uint32_t)n / (uint32_t)d;
+    case DIV_S32:
+        return (uint32_t)((int32_t)n / (int32_t)d);
+    case DIV_MOD_U32:
+        return (uint64_t)((uint32_t)n / (uint32_t)d) << 32 | (uint32_t)n % (uint32_t)d;
+    case DIV_S64:
+        return (uint64_t)((int64_t)n / (int64_t)d);
+    default:
+        return n / d;
+    }
+}
+
+static void fill(uint32_t divCase)
+{
+    uint32_t seed = 1 + divCase;
+    for (uint32_t i = 0; i < OPERANDS; ++i)
+    {
+        uint64_t n = (uint64_t)(seed = seed * 1664525 + 1013904223) << 32;
+        n |= seed = seed * 1664525 + 1013904223;
+        uint64_t d = (seed = seed * 1664525 + 1013904223) | 1;
+        switch (divCase)
+        {
+        case DIV_U64_SMALL:
+            n >>= 32;
+            break;
+        case DIV_U64_BY_U16:
+            d &= 0xffff;
+            break;
+        case DIV_U64:
+        case DIV_S64:
+            d = d << 16 | seed;
+            break;
+        default:
+            d = (d >> (i & 31)) | 1; // From full width down to 1
+            break;
+        }
+        numerators[i] = n;
+        denominators[i] = d;
+    }
+}
+
+static bool check(uint32_t divCase)
+{
+    for (uint32_t i = 0; i < OPERANDS; ++i)
+    {
+        uint64_t n = numerators[i], d = denominators[i], rem, expected;
+        switch (divCase)
+        {
+        case DIV_U32:
+        case DIV_MOD_U32:
+            expected = referenceDivide((uint32_t)n, (uint32_t)d, &rem);
+            if (divCase == DIV_MOD_U32)
+                expected = expected << 32 | rem;
+            break;
+        case DIV_S32:
+        {
+            int32_t sn = n, sd = d;
+            expected = referenceDivide(sn < 0 ? -(int64_t)sn : sn, sd < 0 ? -(int64_t)sd : sd, &rem);
+            expected = (uint32_t)((sn < 0) != (sd < 0) ? -(int32_t)expected : (int32_t)expected);
+            break;
+        }
+        case DIV_S64:
+        {
+            int64_t sn = n, sd = d;
+            expected = referenceDivide(sn < 0 ? -(uint64_t)sn : (uint64_t)sn, sd < 0 ? -(uint64_t)sd : (uint64_t)sd, &rem);
+            expected = (sn < 0) != (sd < 0) ? -expected : expected;
+            break;
+        }
+        default:
+            expected = referenceDivide(n, d, &rem);
+            break;
+        }
+        if (divide(divCase, n, d) != expected)
+            return false;
+    }
+    return true;
+}
+
+static uint32_t measure(uint32_t divCase)
+{
+    uint64_t n[OPERANDS], d[OPERANDS];
+    for (uint32_t i = 0; i < OPERANDS; ++i)
+    {
+        n[i] = numerators[i];
+        d[i] = denominators[i];
+    }
+
+    // The loop alone is timed and taken off
+    uint32_t start = SYST_CVR;
+    for (uint32_t i = 0; i < OPERANDS; ++i)
+        sink = n[i] ^ d[i] ^ divCase;
+    uint32_t overhead = elapsed(start);
+
+    start = SYST_CVR;
+    for (uint32_t i = 0; i < OPERANDS; ++i)
+        sink = divide(divCase, n[i], d[i]);
+    return (elapsed(start) - overhead) / OPERANDS;
+}
+
+int main(void)
+{
+    SYST_RVR = 0xffffff; // Count down from the largest value
+    SYST_CVR = 0;
+    SYST_CSR = (1 << 2) | (1 << 0); // Count processor clock cycles, no interrupt
+
+    bool ok = true;
+    for (uint32_t divCase = 0; divCase < DIV_CASES; ++divCase)
+    {
+        fill(divCase);
+        ok &= check(divCase);
+        divCycles[divCase] = measure(divCase);
+    }
+    divisionsOk = ok;
+
+    benchDone = true;
+    while (true)
+        asm volatile ("wfi");
+}
@@ -0,0 +1,132 @@
+// On-target DMA versus CPU copy benchmark, build with make benchTarget BENCH=dmaCopy
+// and read the results with a debugger once benchDone is set.
+//
+// Every size is copied and filled by the CPU and by a DMA channel, timed with SysTick from the call to the end of
+// the completion interrupt. The crossover is the smallest size the DMA finishes first, a starting point for
+// DMA_MIN_BYTES. The CPU is free for other work while the DMA runs, so the real break-even lies lower still.
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../dma_rp2040.h"
+
+// Define necessary register addresses
+// SysTick
+#define SYST_CSR                    (*(volatile uint32_t *) (0xe000e010))
+#define SYST_RVR                    (*(volatile uint32_t *) (0xe000e014))
+#define SYST_CVR                    (*(volatile uint32_t *) (0xe000e018))
+
+#define SIZES                       (10)        // 16 bytes to 8kB
+#define MIN_SIZE                    (16)
+#define RUNS                        (16)
+
+// Results in clk_sys cycles per call, averaged over RUNS
+volatile uint32_t cpuCopyCycles[SIZES], dmaCopyCycles[SIZES];
+volatile uint32_t cpuFillCycles[SIZES], dmaFillCycles[SIZES];
+volatile uint32_t copyCrossover, fillCrossover;     // Bytes, 0 if the CPU always won
+volatile bool memcpyOk, scatterGatherOk;            // Results of dmaMemcpy and dmaScatterGather checked
+volatile bool benchDone;
+
+static uint32_t src[(MIN_SIZE << (SIZES - 1)) / 4];
+static uint32_t dst[(MIN_SIZE << (SIZES - 1)) / 4];
+static uint32_t fill;
+
+static volatile bool done;
+
+static void dmaDone(uint32_t channel, void *arg)
+{
+    (void)channel;
+    (void)arg;
+    done = true;
+}
+
+static inline uint32_t elapsed(uint32_t start)
+{
+    return (start - SYST_CVR) & 0xffffff; // SysTick counts down
+}
+
+// One channel is kept claimed, so the DMA side pays for the setup and the interrupt but not for the claim
+static void measure(uint32_t channel, uint32_t size, uint32_t *cpuCopy, uint32_t *dmaCopy, uint32_t *cpuFill, uint32_t *dmaFill)
+{
+    *cpuCopy = *dmaCopy = *cpuFill = *dmaFill = 0;
+    for (uint32_t run = 0; run < RUNS; ++run)
+    {
+        uint32_t start = SYST_CVR;
+        memcpy(dst, src, size);
+        *cpuCopy += elapsed(start);
+
+        done = false;
+        start = SYST_CVR;
+        dmaStart(channel, src, dst, size / 4, DMA_SIZE_WORD | DMA_INCR_READ | DMA_INCR_WRITE | DMA_TREQ(DREQ_PERMANENT), dmaDone, 0);
+        while (!done);
+        *dmaCopy += elapsed(start);
+
+        start = SYST_CVR;
+        memset(dst, 0x5a, size);
+        *cpuFill += elapsed(start);
+
+        done = false;
+        start = SYST_CVR;
+        fill = 0x5a5a5a5a;
+        dmaStart(channel, &fill, dst, size / 4, DMA_SIZE_WORD | DMA_INCR_WRITE | DMA_TREQ(DREQ_PERMANENT), dmaDone, 0);
+        while (!done);
+        *dmaFill += elapsed(start);
+    }
+    *cpuCopy /= RUNS;
+    *dmaCopy /= RUNS;
+    *cpuFill /= RUNS;
+    *dmaFill /= RUNS;
+}
+
+int main(void)
+{
+    SYST_RVR = 0xffffff; // Count down from the largest value
+    SYST_CVR = 0;
+    SYST_CSR = (1 << 2) | (1 << 0); // Count processor clock cycles, no interrupt
+
+    for (uint32_t i = 0; i < sizeof(src) / 4; ++i)
+        src[i] = i * 0x9e3779b9;
+
+    int32_t channel = dmaClaim();
+    copyCrossover = fillCrossover = 0;
+    for (uint32_t i = 0; i < SIZES; ++i)
+    {
+        uint32_t size = MIN_SIZE << i;
+        uint32_t cpuCopy, dmaCopy, cpuFill, dmaFill;
+        measure(channel, size, &cpuCopy, &dmaCopy, &cpuFill, &dmaFill);
+        cpuCopyCycles[i] = cpuCopy;
+        dmaCopyCycles[i] = dmaCopy;
+        cpuFillCycles[i] = cpuFill;
+        dmaFillCycles[i] = dmaFill;
+        if (!copyCrossover && dmaCopy < cpuCopy)
+            copyCrossover = size;
+        if (!fillCrossover && dmaFill < cpuFill)
+            fillCrossover = size;
+    }
+    dmaRelease(channel);
+
+    // dmaMemcpy with both ends misaligned, so the CPU does a head and a tail around the DMA words
+    done = false;
+    memset(dst, 0, sizeof(dst));
+    if (dmaMemcpy((uint8_t *)dst + 1, (uint8_t *)src + 1, 1000, dmaDone, 0) >= 0)
+        while (!done);
+    memcpyOk = !memcmp((uint8_t *)dst + 1, (uint8_t *)src + 1, 1000) && !((uint8_t *)dst)[0] && !((uint8_t *)dst)[1001];
+
+    // Gather three pieces of src back to back into dst
+    static dmaBlock blocks[3 + 1];
+    int32_t dataChannel = dmaClaim(), ctrlChannel = dmaClaim();
+    uint32_t ctrl = DMA_SIZE_WORD | DMA_INCR_READ | DMA_INCR_WRITE | DMA_TREQ(DREQ_PERMANENT);
+    dmaBlockSet(&blocks[0], &src[100], &dst[0], 10, ctrl);
+    dmaBlockSet(&blocks[1], &src[300], &dst[10], 20, ctrl);
+    dmaBlockSet(&blocks[2], &src[700], &dst[30], 5, ctrl);
+    done = false;
+    dmaScatterGather(dataChannel, ctrlChannel, blocks, 3, dmaDone, 0);
+    while (!done);
+    scatterGatherOk = !memcmp(&dst[0], &src[100], 40) && !memcmp(&dst[10], &src[300], 80) && !memcmp(&dst[30], &src[700], 20);
+    dmaRelease(dataChannel);
+    dmaRelease(ctrlChannel);
+
+    benchDone = true;
+    while (true)
+        asm volatile ("wfi");
+}
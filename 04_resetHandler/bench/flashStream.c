@@ -0,0 +1,88 @@
+// On-target bulk flash read benchmark, build with make benchTarget BENCH=flashStream
+// and read the results with a debugger once benchDone is set.
+//
+// Copies a block of flash into SRAM by memcpy through the cached XIP window and by flashStreamRead.
+// Before every copy all of .text is pulled into the cache, afterwards it is walked again with the counters
+// running. The hit rate of that walk is the share of the code the copy left in the cache.
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../timer_rp2040.h"
+#include "../xip_rp2040.h"
+
+// Flash well past the image, read as a stand-in for a large constant table or asset
+#define BULK_OFFSET                 (0x00100000)
+#define BULK_SIZE                   (32768)
+#define RUNS                        (16)
+
+#define XIP_BASE                    (0x10000000)
+
+enum
+{
+    BULK_MEMCPY,            // memcpy from 0x10000000 + BULK_OFFSET
+    BULK_STREAM,            // flashStreamRead
+    BULK_CASES
+};
+
+typedef struct
+{
+    uint32_t bytesPerSecond;
+    uint32_t codeHitPermille;   // Lines of .text still cached after the copy, per mille
+} bulkResult;
+
+volatile bulkResult bulkResults[BULK_CASES];
+volatile bool benchDone;
+
+extern uint32_t _stext, _etext;
+
+static uint32_t buffer[BULK_SIZE / 4];
+
+static void streamDone(void *arg)
+{
+    *(volatile bool *)arg = true;
+}
+
+static void measure(uint32_t bulkCase)
+{
+    uint32_t textSize = (uint32_t)&_etext - (uint32_t)&_stext;
+    uint64_t total = 0;
+    uint32_t hits = 0, accesses = 0;
+    for (uint32_t run = 0; run < RUNS; ++run)
+    {
+        xipCachePrefetch(&_stext, textSize);
+
+        uint64_t start = readTime();
+        if (bulkCase == BULK_MEMCPY)
+        {
+            memcpy(buffer, (const void *)(XIP_BASE + BULK_OFFSET), BULK_SIZE);
+        }
+        else
+        {
+            volatile bool done = false;
+            flashStreamRead(buffer, BULK_OFFSET, BULK_SIZE, streamDone, (void *)&done);
+            while (!done)
+                asm volatile ("wfi");
+        }
+        total += readTime() - start;
+
+        xipCountersReset();
+        xipCachePrefetch(&_stext, textSize);
+        xipCounters counters = xipCountersRead();
+        hits += counters.hits;
+        accesses += counters.accesses;
+    }
+
+    bulkResults[bulkCase].bytesPerSecond = (uint64_t)BULK_SIZE * RUNS * 1000000 / total;
+    bulkResults[bulkCase].codeHitPermille = (uint64_t)hits * 1000 / accesses;
+}
+
+int main(void)
+{
+    for (uint32_t bulkCase = 0; bulkCase < BULK_CASES; ++bulkCase)
+        measure(bulkCase);
+
+    benchDone = true;
+    while (true)
+        asm volatile ("wfi");
+}
@@ -0,0 +1,96 @@
+// On-target interpolator kernel benchmark, build with make benchTarget BENCH=interp
+// and read the results with a debugger once benchDone is set. make interpHost checks the kernels on the host.
+//
+// Every kernel of interp_rp2040.h runs over the same data on the interpolators and as its C version, timed with
+// SysTick. The results are in hundredths of a clk_sys cycle per element, resultsMatch compares the outputs.
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../interp_rp2040.h"
+
+// Define necessary register addresses
+// SysTick
+#define SYST_CSR                    (*(volatile uint32_t *) (0xe000e010))
+#define SYST_RVR                    (*(volatile uint32_t *) (0xe000e014))
+#define SYST_CVR                    (*(volatile uint32_t *) (0xe000e018))
+
+#define ELEMENTS                    (1024)
+#define TABLE_BITS                  (10)
+
+enum
+{
+    KERNEL_TABLE_LOOKUP,
+    KERNEL_BLEND,
+    KERNEL_SCALE,
+    KERNEL_EXTRACT,
+    KERNELS
+};
+
+volatile uint32_t interpCyclesX100[KERNELS], cCyclesX100[KERNELS];
+volatile bool resultsMatch;
+volatile bool benchDone;
+
+static int16_t a[ELEMENTS], b[ELEMENTS], table[1 << TABLE_BITS];
+static uint32_t words[ELEMENTS];
+static union
+{
+    int16_t samples[ELEMENTS];
+    uint32_t words[ELEMENTS];
+} interpOut, cOut;
+
+static inline uint32_t elapsed(uint32_t start)
+{
+    return (start - SYST_CVR) & 0xffffff; // SysTick counts down
+}
+
+static uint32_t run(uint32_t kernel, bool useInterp)
+{
+    uint32_t start = SYST_CVR;
+    switch (kernel)
+    {
+    case KERNEL_TABLE_LOOKUP:
+        (useInterp ? interpTableLookup : interpTableLookupC)((useInterp ? &interpOut : &cOut)->samples, table, TABLE_BITS, 0, 0x00c0ffee, ELEMENTS);
+        break;
+    case KERNEL_BLEND:
+        (useInterp ? interpBlend : interpBlendC)((useInterp ? &interpOut : &cOut)->samples, a, b, 0, 0x40, ELEMENTS);
+        break;
+    case KERNEL_SCALE:
+        (useInterp ? interpScale : interpScaleC)((useInterp ? &interpOut : &cOut)->samples, a, 0x00018000, 15, INT16_MIN, INT16_MAX, ELEMENTS);
+        break;
+    case KERNEL_EXTRACT:
+        (useInterp ? interpExtract : interpExtractC)((useInterp ? &interpOut : &cOut)->words, words, 5, 11, true, ELEMENTS);
+        break;
+    }
+    return elapsed(start) * 100 / ELEMENTS;
+}
+
+int main(void)
+{
+    SYST_RVR = 0xffffff; // Count down from the largest value
+    SYST_CVR = 0;
+    SYST_CSR = (1 << 2) | (1 << 0); // Count processor clock cycles, no interrupt
+
+    uint32_t seed = 1;
+    for (uint32_t i = 0; i < ELEMENTS; ++i)
+    {
+        a[i] = (seed = seed * 1664525 + 1013904223) >> 16;
+        b[i] = (seed = seed * 1664525 + 1013904223) >> 16;
+        words[i] = seed = seed * 1664525 + 1013904223;
+    }
+    for (uint32_t i = 0; i < (1 << TABLE_BITS); ++i)
+        table[i] = (seed = seed * 1664525 + 1013904223) >> 16;
+
+    bool match = true;
+    for (uint32_t kernel = 0; kernel < KERNELS; ++kernel)
+    {
+        interpCyclesX100[kernel] = run(kernel, true);
+        cCyclesX100[kernel] = run(kernel, false);
+        match &= !memcmp(&interpOut, &cOut, sizeof(cOut));
+    }
+    resultsMatch = match;
+
+    benchDone = true;
+    while (true)
+        asm volatile ("wfi");
+}
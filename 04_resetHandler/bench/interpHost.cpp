@@ -0,0 +1,102 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "../interp_rp2040.h"
+
+// Runs every kernel of interp_rp2040.c against the interpolator model in interpModel.cpp and compares the output
+// bit for bit with its C version, over random data and a sweep of the parameters
+#define ELEMENTS                    (1000)
+
+static uint32_t seed = 1;
+
+static uint32_t random32()
+{
+    seed = seed * 1664525 + 1013904223;
+    return seed ^ (seed >> 15) * 0x2c1b3c6d;
+}
+
+static int failures;
+
+static void check(const char *name, bool pass)
+{
+    failures += !pass;
+    std::cout << std::left << std::setw(48) << name << (pass ? "ok" : "FAIL") << std::endl;
+}
+
+int main()
+{
+    std::vector<int16_t> a(ELEMENTS), b(ELEMENTS), hw(ELEMENTS), ref(ELEMENTS), table(1 << 12);
+    std::vector<uint32_t> words(ELEMENTS), hw32(ELEMENTS), ref32(ELEMENTS);
+    for (uint32_t i = 0; i < ELEMENTS; ++i)
+    {
+        a[i] = random32();
+        b[i] = random32();
+        words[i] = random32();
+    }
+    for (int16_t &entry : table)
+        entry = random32();
+
+    bool same = true;
+    for (uint32_t tableBits = 1; tableBits <= 12; ++tableBits)
+    {
+        uint32_t phase = random32(), step = random32() >> (tableBits & 7);
+        uint32_t hwPhase = interpTableLookup(hw.data(), table.data(), tableBits, phase, step, ELEMENTS);
+        uint32_t refPhase = interpTableLookupC(ref.data(), table.data(), tableBits, phase, step, ELEMENTS);
+        same &= hw == ref && hwPhase == refPhase;
+    }
+    check("interpTableLookup, 2 - 4096 entries", same);
+
+    same = true;
+    for (uint32_t run = 0; run < 16; ++run)
+    {
+        uint32_t alpha = random32(), step = random32() >> (run + 8);
+        uint32_t hwAlpha = interpBlend(hw.data(), a.data(), b.data(), alpha, step, ELEMENTS);
+        uint32_t refAlpha = interpBlendC(ref.data(), a.data(), b.data(), alpha, step, ELEMENTS);
+        same &= hw == ref && hwAlpha == refAlpha;
+    }
+    check("interpBlend, full scale samples", same);
+
+    same = true;
+    for (uint32_t shift = 0; shift < 32; ++shift)
+    {
+        int32_t gain = (int32_t)random32() >> (random32() % 24);
+        interpScale(hw.data(), a.data(), gain, shift, INT16_MIN, INT16_MAX, ELEMENTS);
+        interpScaleC(ref.data(), a.data(), gain, shift, INT16_MIN, INT16_MAX, ELEMENTS);
+        same &= hw == ref;
+        interpScale(hw.data(), a.data(), gain, shift, -1000, 2000, ELEMENTS);
+        interpScaleC(ref.data(), a.data(), gain, shift, -1000, 2000, ELEMENTS);
+        same &= hw == ref;
+    }
+    check("interpScale, every shift and two clamp ranges", same);
+
+    same = true;
+    for (uint32_t width = 1; width <= 32; ++width)
+    {
+        for (uint32_t lsb = 0; lsb + width <= 32; ++lsb)
+        {
+            for (bool isSigned : {false, true})
+            {
+                interpExtract(hw32.data(), words.data(), lsb, width, isSigned, 64);
+                interpExtractC(ref32.data(), words.data(), lsb, width, isSigned, 64);
+                same &= hw32 == ref32;
+            }
+        }
+    }
+    check("interpExtract, every field, signed and unsigned", same);
+
+    // A handler bracketed by save and restore leaves a lookup in progress undisturbed
+    interpTableLookup(hw.data(), table.data(), 8, 0x12345678, 0x01000000, 10);
+    interpState state;
+    interpSave(0, &state);
+    interpExtract(hw32.data(), words.data(), 3, 5, true, 10);
+    interpRestore(0, &state);
+    uint32_t hwPhase = interpTableLookup(hw.data(), table.data(), 8, 0x12345678 + 10 * 0x01000000, 0x01000000, 10);
+    interpState after;
+    interpSave(0, &after);
+    check("interpSave and interpRestore", hwPhase == 0x12345678 + 20 * 0x01000000 && state.ctrl[0] == after.ctrl[0]);
+
+    if (failures)
+        std::cout << failures << " check(s) failed. Exiting ..." << std::endl;
+    return failures ? 1 : 0;
+}
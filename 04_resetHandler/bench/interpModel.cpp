@@ -0,0 +1,134 @@
+#include <cstdint>
+
+#include "interpModel.h"
+
+// Software model of an SIO interpolator, following the datasheet description of the lanes. Covers every register
+// and control bit, the kernels use only some of them.
+struct interpModel
+{
+    uint32_t accum[2], base[2], ctrl[2];
+    uintptr_t base2;
+    bool hasBlend, hasClamp;
+
+    static uint32_t field(uint32_t ctrl, uint32_t shift, uint32_t width) { return (ctrl >> shift) & ((1u << width) - 1); }
+
+    // Shift and mask of a lane, sign extended from the top of the mask if SIGNED
+    uint32_t masked(uint32_t lane) const
+    {
+        uint32_t c = ctrl[lane];
+        uint32_t input = accum[field(c, 16, 1) ? lane ^ 1 : lane];     // CROSS_INPUT
+        uint32_t lsb = field(c, 5, 5), msb = field(c, 10, 5);
+        uint32_t mask = (msb == 31 ? 0xffffffff : (1u << (msb + 1)) - 1) & ~((1u << lsb) - 1);
+        uint32_t value = (input >> field(c, 0, 5)) & mask;
+        if (field(c, 15, 1) && msb < 31 && (value & (1u << msb)))      // SIGNED
+            value |= ~((1u << (msb + 1)) - 1);
+        return value;
+    }
+
+    uint32_t laneResult(uint32_t lane) const
+    {
+        uint32_t c = ctrl[lane];
+        uint32_t result;
+        if (lane == 0 && hasBlend && field(ctrl[0], 21, 1))
+        {
+            result = masked(1) & 0xff; // The blend fraction without BASE0
+        }
+        else if (lane == 1 && hasBlend && field(ctrl[0], 21, 1))
+        {
+            // BASE0 to BASE1 by the fraction in 1/256, signed or not as lane 1 is
+            uint32_t alpha = masked(1) & 0xff;
+            if (field(ctrl[1], 15, 1))
+                result = (uint32_t)(((int64_t)(int32_t)base[0] * (256 - alpha) + (int64_t)(int32_t)base[1] * alpha) >> 8);
+            else
+                result = (uint32_t)(((uint64_t)base[0] * (256 - alpha) + (uint64_t)base[1] * alpha) >> 8);
+        }
+        else if (lane == 0 && hasClamp && field(ctrl[0], 22, 1))
+        {
+            uint32_t value = masked(0);
+            if (field(c, 15, 1))
+                result = (int32_t)value < (int32_t)base[0] ? base[0] : (int32_t)value > (int32_t)base[1] ? base[1] : value;
+            else
+                result = value < base[0] ? base[0] : value > base[1] ? base[1] : value;
+        }
+        else
+        {
+            result = (field(c, 18, 1) ? accum[field(c, 16, 1) ? lane ^ 1 : lane] : masked(lane)) + base[lane];  // ADD_RAW
+        }
+        return result | field(c, 19, 2) << 28; // FORCE_MSB
+    }
+
+    uintptr_t fullResult() const
+    {
+        if (hasBlend && field(ctrl[0], 21, 1))
+            return base2 + masked(0);
+        return base2 + masked(0) + masked(1);
+    }
+
+    // Both accumulators take their lane result, or that of the other lane with CROSS_RESULT
+    void pop()
+    {
+        uint32_t result[2] = {laneResult(0), laneResult(1)};
+        for (uint32_t lane = 0; lane < 2; ++lane)
+            accum[lane] = result[field(ctrl[lane], 17, 1) ? lane ^ 1 : lane];
+    }
+};
+
+static interpModel interps[2] = {{{}, {}, {}, 0, true, false}, {{}, {}, {}, 0, false, true}};
+
+static interpModel &decode(uint32_t addr, uint32_t &offset)
+{
+    uint32_t index = (addr - INTERP_BASE(0)) / 0x40;
+    offset = (addr - INTERP_BASE(0)) % 0x40;
+    return interps[index];
+}
+
+interpMmio::operator uintptr_t() const
+{
+    uint32_t offset;
+    interpModel &interp = decode(addr, offset);
+    uintptr_t value = 0;
+    switch (offset)
+    {
+    case 0x00: value = interp.accum[0]; break;
+    case 0x04: value = interp.accum[1]; break;
+    case 0x08: value = interp.base[0]; break;
+    case 0x0c: value = interp.base[1]; break;
+    case 0x10: value = interp.base2; break;
+    case 0x14: value = interp.laneResult(0); interp.pop(); break;  // POP_LANE0
+    case 0x18: value = interp.laneResult(1); interp.pop(); break;  // POP_LANE1
+    case 0x1c: value = interp.fullResult(); interp.pop(); break;   // POP_FULL
+    case 0x20: value = interp.laneResult(0); break;
+    case 0x24: value = interp.laneResult(1); break;
+    case 0x28: value = interp.fullResult(); break;
+    case 0x2c: value = interp.ctrl[0]; break;
+    case 0x30: value = interp.ctrl[1]; break;
+    case 0x34: value = interp.masked(0); break;                     // ACCUM0_ADD reads the masked value
+    case 0x38: value = interp.masked(1); break;
+    }
+    return value;
+}
+
+interpMmio &interpMmio::operator=(uintptr_t value)
+{
+    uint32_t offset;
+    interpModel &interp = decode(addr, offset);
+    uint32_t word = (uint32_t)value;
+    switch (offset)
+    {
+    case 0x00: interp.accum[0] = word; break;
+    case 0x04: interp.accum[1] = word; break;
+    case 0x08: interp.base[0] = word; break;
+    case 0x0c: interp.base[1] = word; break;
+    case 0x10: interp.base2 = value; break;
+    case 0x2c: interp.ctrl[0] = word; break;
+    case 0x30: interp.ctrl[1] = word; break;
+    case 0x34: interp.accum[0] += word; break;
+    case 0x38: interp.accum[1] += word; break;
+    case 0x3c:
+        // Each half goes to its base, sign extended if that lane is signed
+        interp.base[0] = interpModel::field(interp.ctrl[0], 15, 1) ? (uint32_t)(int16_t)word : word & 0xffff;
+        interp.base[1] = interpModel::field(interp.ctrl[1], 15, 1) ? (uint32_t)(int32_t)(int16_t)(word >> 16) : word >> 16;
+        break;
+    }
+    return *this;
+}
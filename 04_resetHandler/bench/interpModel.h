@@ -0,0 +1,36 @@
+#ifndef INTERP_MODEL_H
+#define INTERP_MODEL_H
+
+#include <cstdint>
+
+// Register proxy routing every interpolator access of interp_rp2040.c to the model in interpModel.cpp.
+// BASE2 and the full result are as wide as a host pointer, so the address generation works on 64-bit hosts too.
+struct interpMmio
+{
+    uint32_t addr;
+    operator uintptr_t() const;
+    interpMmio &operator=(uintptr_t value);
+    // A full result used as an address
+    template <typename T>
+    explicit operator T *() const { return (T *)(uintptr_t)*this; }
+};
+
+// Register map used by interp_rp2040.c
+#define INTERP_BASE(n)              (0xd0000080 + 0x040 * (n))
+#define INTERP_ACCUM0(n)            (interpMmio{INTERP_BASE(n) + 0x000})
+#define INTERP_ACCUM1(n)            (interpMmio{INTERP_BASE(n) + 0x004})
+#define INTERP_BASE0(n)             (interpMmio{INTERP_BASE(n) + 0x008})
+#define INTERP_BASE1(n)             (interpMmio{INTERP_BASE(n) + 0x00c})
+#define INTERP_BASE2(n)             (interpMmio{INTERP_BASE(n) + 0x010})
+#define INTERP_POP_FULL(n)          (interpMmio{INTERP_BASE(n) + 0x01c})
+#define INTERP_PEEK_LANE0(n)        (interpMmio{INTERP_BASE(n) + 0x020})
+#define INTERP_PEEK_LANE1(n)        (interpMmio{INTERP_BASE(n) + 0x024})
+#define INTERP_CTRL_LANE0(n)        (interpMmio{INTERP_BASE(n) + 0x02c})
+#define INTERP_CTRL_LANE1(n)        (interpMmio{INTERP_BASE(n) + 0x030})
+#define INTERP_ACCUM1_ADD(n)        (interpMmio{INTERP_BASE(n) + 0x038})
+#define INTERP_BASE_1AND0(n)        (interpMmio{INTERP_BASE(n) + 0x03c})
+
+// Everything runs from the same place on the host
+#define TIME_CRITICAL
+
+#endif
@@ -0,0 +1,218 @@
+// Interrupt entry latency and jitter harness. On target, build with make benchTarget BENCH=latency, dump SRAM once
+// benchDone is set and decode with make latencyReport DUMP=sram.bin. On the host, make latencyHost runs the same
+// harness against the timer and NVIC model in latencyMock.cpp and fails if the measured latencies drift from it.
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../irq_rp2040.h"
+#include "../latency.h"
+
+// Define necessary register addresses
+#ifdef HOST_MODEL
+#include "latencyMock.h" // Registers are routed to the host-side model
+#else
+#include "../multicore_rp2040.h"
+#include "../sections.h"
+// SysTick
+#define SYST_CSR                    (*(volatile uint32_t *) (0xe000e010))
+#define SYST_RVR                    (*(volatile uint32_t *) (0xe000e014))
+#define SYST_CVR                    (*(volatile uint32_t *) (0xe000e018))
+// SCB
+#define M0PLUS_VTOR                 (*(volatile uint32_t *) (0xe000ed08))
+// NVIC
+#define NVIC_ISPR                   (*(volatile uint32_t *) (0xe000e200))
+// TIMER
+#define TIMER_ALARM1                (*(volatile uint32_t *) (0x40054014))
+#define TIMER_TIMERAWL              (*(volatile uint32_t *) (0x40054028))
+#define TIMER_INTR                  (*(volatile uint32_t *) (0x40054034))
+#define TIMER_INTE_SET              (*(volatile uint32_t *) (0x40054038 + 0x2000))
+#define TIMER_INTE_CLR              (*(volatile uint32_t *) (0x40054038 + 0x3000))
+// SIO
+#define SIO_FIFO_ST                 (*(volatile uint32_t *) (0xd0000050))
+#define SIO_FIFO_WR                 (*(volatile uint32_t *) (0xd0000054))
+#define SIO_FIFO_RD                 (*(volatile uint32_t *) (0xd0000058))
+// XIP
+#define XIP_FLUSH                   (*(volatile uint32_t *) (0x14000004))
+
+#define latencyBarrier()            asm volatile ("isb" ::: "memory")
+#endif
+
+#define RUNS                        (1000)
+
+#ifdef HOST_MODEL
+latencyBuffer latencyBuf;
+#else
+latencyBuffer latencyBuf __attribute__((section(".noinit")));
+volatile bool benchDone;
+#endif
+
+static volatile uint32_t entryStamp;
+static volatile bool entered;
+
+// Handlers read SysTick first thing and only then acknowledge their source
+#define LATENCY_HANDLER(name, attr, ack)                \
+    attr void name(void)                                \
+    {                                                   \
+        entryStamp = SYST_CVR;                          \
+        entered = true;                                 \
+        ack;                                            \
+    }
+
+#define ACK_NVIC                    (void)0
+#define ACK_TIMER                   TIMER_INTR = 1 << 1
+#define ACK_FIFO                    while (SIO_FIFO_ST & 1) (void)SIO_FIFO_RD
+
+LATENCY_HANDLER(nvicFlash, static, ACK_NVIC)
+LATENCY_HANDLER(timerFlash, static, ACK_TIMER)
+LATENCY_HANDLER(fifoFlash, static, ACK_FIFO)
+LATENCY_HANDLER(nvicSram, TIME_CRITICAL static, ACK_NVIC)
+LATENCY_HANDLER(timerSram, TIME_CRITICAL static, ACK_TIMER)
+LATENCY_HANDLER(fifoSram, TIME_CRITICAL static, ACK_FIFO)
+
+// Vector table in flash holding only the interrupts the harness fires, selected for the flash cases
+static const irqHandler flashVector[48] __attribute__((aligned(256))) =
+{
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,     // Arm exceptions, a fault meanwhile locks up
+    0, timerFlash, 0, 0, 0, 0, 0, 0,                    // TIMER_IRQ_1
+    0, 0, 0, 0, 0, 0, 0, fifoFlash,                     // SIO_IRQ_PROC0
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, nvicFlash,                                       // RTC_IRQ
+};
+
+extern irqHandler ramVector[];
+
+static void useTable(const irqHandler *table, uint32_t placement)
+{
+#ifdef HOST_MODEL
+    mockUseTable(table, placement == LATENCY_FLASH);
+#else
+    (void)placement;
+    M0PLUS_VTOR = (uint32_t)table;
+    latencyBarrier();
+#endif
+}
+
+// Event raised in software, so its time is known exactly
+TIME_CRITICAL static uint32_t measurePended(void)
+{
+    entered = false;
+    uint32_t start = SYST_CVR;
+    NVIC_ISPR = 1 << RTC_IRQ;
+    latencyBarrier(); // Taken right here
+    return (start - entryStamp) & 0xffffff; // SysTick counts down
+}
+
+// Event raised by hardware at a moment the CPU does not see, so SysTick is sampled until the handler has run.
+// The last sample before the handler is the event time, late by less than one loop iteration.
+TIME_CRITICAL static uint32_t measureSampled(uint32_t source, latencyResult *result)
+{
+    entered = false;
+    if (source == LATENCY_TIMER)
+        TIMER_ALARM1 = TIMER_TIMERAWL + 2; // Fires in 1 - 2us
+    else
+        SIO_FIFO_WR = 0; // Core1 echoes it back
+
+    uint32_t older, prev, cur = SYST_CVR;
+    prev = older = cur;
+    do
+    {
+        older = prev;
+        prev = cur;
+        cur = SYST_CVR;
+    } while (!entered);
+
+    // If cur was read after the handler, prev is the last sample before it and older to prev an undisturbed iteration
+    uint32_t sample, period;
+    if (((entryStamp - cur) & 0xffffff) < 0x800000)
+    {
+        sample = prev;
+        period = (older - prev) & 0xffffff;
+    }
+    else
+    {
+        sample = cur;
+        period = (prev - cur) & 0xffffff;
+    }
+    if (period > result->resolution)
+        result->resolution = period;
+    return (sample - entryStamp) & 0xffffff;
+}
+
+static void xipFlush(void)
+{
+    XIP_FLUSH = 1;
+    (void)XIP_FLUSH; // Reading stalls until the flush is done
+}
+
+// Run every source, placement and cache state RUNS times into latencyBuf
+void latencyRun(void)
+{
+    latencyBuf.magic = LATENCY_MAGIC;
+    latencyBuf.cases = LATENCY_CASES;
+    memset(latencyBuf.results, 0, sizeof(latencyBuf.results));
+
+    irqHandler old[3] =
+    {
+        irqSetHandler(RTC_IRQ, nvicSram),
+        irqSetHandler(TIMER_IRQ_1, timerSram),
+        irqSetHandler(SIO_IRQ_PROC0, fifoSram),
+    };
+    TIMER_INTE_SET = 1 << 1;
+    irqEnable(RTC_IRQ);
+    irqEnable(TIMER_IRQ_1);
+    irqEnable(SIO_IRQ_PROC0);
+
+    for (uint32_t placement = LATENCY_FLASH; placement <= LATENCY_SRAM; ++placement)
+    {
+        useTable(placement == LATENCY_FLASH ? flashVector : ramVector, placement);
+        for (uint32_t cache = LATENCY_WARM; cache <= LATENCY_COLD; ++cache)
+        {
+            for (uint32_t source = 0; source < LATENCY_SOURCES; ++source)
+            {
+                latencyResult *result = &latencyBuf.results[LATENCY_CASE(source, placement, cache)];
+                for (uint32_t run = 0; run < RUNS; ++run)
+                {
+                    if (cache == LATENCY_COLD)
+                        xipFlush();
+                    latencyRecord(result, source == LATENCY_NVIC ? measurePended() : measureSampled(source, result));
+                }
+            }
+        }
+    }
+
+    irqDisable(RTC_IRQ);
+    irqDisable(TIMER_IRQ_1);
+    irqDisable(SIO_IRQ_PROC0);
+    TIMER_INTE_CLR = 1 << 1;
+    useTable(ramVector, LATENCY_SRAM);
+    irqSetHandler(RTC_IRQ, old[0]);
+    irqSetHandler(TIMER_IRQ_1, old[1]);
+    irqSetHandler(SIO_IRQ_PROC0, old[2]);
+}
+
+#ifndef HOST_MODEL
+// Core1 sends every word it receives straight back
+TIME_CRITICAL static void fifoEcho(void)
+{
+    while (true)
+    {
+        while (!(SIO_FIFO_ST & 1));
+        SIO_FIFO_WR = SIO_FIFO_RD;
+    }
+}
+
+int main(void)
+{
+    SYST_RVR = 0xffffff; // Count down from the largest value
+    SYST_CVR = 0;
+    SYST_CSR = (1 << 2) | (1 << 0); // Count processor clock cycles, no interrupt
+
+    core1Launch(fifoEcho);
+    latencyRun();
+
+    benchDone = true;
+    while (true)
+        asm volatile ("wfi");
+}
+#endif
@@ -0,0 +1,154 @@
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+#include "latencyMock.h"
+#include "../latency.h"
+
+// Timing model, the harness is expected to measure exactly these entry latencies
+#define ACCESS_CYCLES               (2)     // Register access
+#define ENTRY_CYCLES                (15)    // Exception entry with zero wait state memory
+#define XIP_MISS_CYCLES             (24)    // Refill of an XIP cache line
+#define CYCLES_PER_US               (100)   // TIMER tick
+#define ECHO_CYCLES                 (10)    // Core1 noticing the FIFO word and writing it back
+
+void latencyRun();
+extern latencyBuffer latencyBuf;
+
+irqHandler ramVector[48];
+
+static uint64_t cycles;
+static uint64_t pendingAt[IRQ_COUNT];       // Cycle the interrupt becomes pending, set to UINT64_MAX by irqEnable
+static uint32_t enabled;
+static const irqHandler *table = ramVector;
+static bool tableInFlash, xipCold, inHandler;
+
+// Take the lowest numbered pending interrupt, after a flush the vector and the handler both miss in a flash table
+static void deliver()
+{
+    if (inHandler)
+        return;
+    for (uint32_t irq = 0; irq < IRQ_COUNT; ++irq)
+    {
+        if (!(enabled & (1 << irq)) || pendingAt[irq] > cycles)
+            continue;
+        pendingAt[irq] = UINT64_MAX;
+        cycles += ENTRY_CYCLES;
+        if (tableInFlash && xipCold)
+            cycles += 2 * XIP_MISS_CYCLES;
+        xipCold = false;
+        inHandler = true;
+        table[16 + irq]();
+        inHandler = false;
+        return;
+    }
+}
+
+mockMmio::operator uint32_t() const
+{
+    uint64_t now = cycles;
+    cycles += ACCESS_CYCLES;
+    uint32_t value = 0;
+    if (addr == 0xe000e018)
+        value = (0xffffff - now) & 0xffffff; // SysTick counts down
+    else if (addr == 0x40054028)
+        value = now / CYCLES_PER_US;
+    deliver();
+    return value;
+}
+
+mockMmio &mockMmio::operator=(uint32_t value)
+{
+    uint64_t now = cycles;
+    cycles += ACCESS_CYCLES;
+    if (addr == 0xe000e200)
+    {
+        for (uint32_t irq = 0; irq < IRQ_COUNT; ++irq)
+        {
+            if (value & (1 << irq))
+                pendingAt[irq] = now;
+        }
+    }
+    else if (addr == 0x40054014)
+        pendingAt[TIMER_IRQ_1] = (uint64_t)value * CYCLES_PER_US; // The counter has not wrapped in the model
+    else if (addr == 0xd0000054)
+        pendingAt[SIO_IRQ_PROC0] = now + ECHO_CYCLES;
+    else if (addr == 0x14000004)
+        xipCold = true;
+    deliver();
+    return *this;
+}
+
+void mockBarrier()
+{
+    deliver();
+}
+
+void mockUseTable(const irqHandler *newTable, bool flash)
+{
+    table = newTable;
+    tableInFlash = flash;
+}
+
+irqHandler irqSetHandler(uint32_t irq, irqHandler handler)
+{
+    irqHandler old = ramVector[16 + irq];
+    ramVector[16 + irq] = handler;
+    return old;
+}
+
+void irqEnable(uint32_t irq)
+{
+    pendingAt[irq] = UINT64_MAX;
+    enabled |= 1 << irq;
+}
+
+void irqDisable(uint32_t irq)
+{
+    enabled &= ~(1 << irq);
+}
+
+int main(int argc, char *argv[])
+{
+    std::string dumpPath;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg.rfind("--dump=", 0) == 0)
+            dumpPath = arg.substr(7);
+    }
+
+    latencyRun();
+
+    // The measurement adds the register accesses around the event, a sampled event is seen up to one loop late
+    static const char *sourceNames[] = {"NVIC", "TIMER", "FIFO"};
+    int failures = 0;
+    for (uint32_t source = 0; source < LATENCY_SOURCES; ++source)
+    {
+        for (uint32_t placement = LATENCY_FLASH; placement <= LATENCY_SRAM; ++placement)
+        {
+            for (uint32_t cache = LATENCY_WARM; cache <= LATENCY_COLD; ++cache)
+            {
+                const latencyResult &result = latencyBuf.results[LATENCY_CASE(source, placement, cache)];
+                uint32_t expected = ENTRY_CYCLES + ((placement == LATENCY_FLASH && cache == LATENCY_COLD) ? 2 * XIP_MISS_CYCLES : 0);
+                uint32_t slack = 2 * ACCESS_CYCLES + result.resolution;
+                bool pass = result.count && result.min >= expected && result.max <= expected + slack;
+                failures += !pass;
+                std::cout << std::left << std::setw(6) << sourceNames[source] << std::setw(6) << (placement == LATENCY_FLASH ? "flash" : "SRAM")
+                          << std::setw(5) << (cache == LATENCY_COLD ? "cold" : "warm") << std::right << " expected " << std::setw(3) << expected
+                          << " measured " << std::setw(3) << result.min << " - " << std::setw(3) << result.max << (pass ? "  ok" : "  FAIL") << std::endl;
+            }
+        }
+    }
+
+    if (!dumpPath.empty())
+    {
+        std::ofstream dump(dumpPath, std::ios::binary);
+        dump.write((const char *)&latencyBuf, sizeof(latencyBuf));
+    }
+
+    if (failures)
+        std::cout << failures << " case(s) outside of the model. Exiting ..." << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,39 @@
+#ifndef LATENCY_MOCK_H
+#define LATENCY_MOCK_H
+
+#include <cstdint>
+
+#include "../irq_rp2040.h"
+
+// Register proxy routing every access made by the harness to the model. Each access takes time in the model
+// and an interrupt that became pending meanwhile is taken right after it.
+struct mockMmio
+{
+    uint32_t addr;
+    operator uint32_t() const;
+    mockMmio &operator=(uint32_t value);
+};
+
+// Register map used by the harness
+#define SYST_CSR                    (mockMmio{0xe000e010})
+#define SYST_RVR                    (mockMmio{0xe000e014})
+#define SYST_CVR                    (mockMmio{0xe000e018})
+#define NVIC_ISPR                   (mockMmio{0xe000e200})
+#define TIMER_ALARM1                (mockMmio{0x40054014})
+#define TIMER_TIMERAWL              (mockMmio{0x40054028})
+#define TIMER_INTR                  (mockMmio{0x40054034})
+#define TIMER_INTE_SET              (mockMmio{0x40056038})
+#define TIMER_INTE_CLR              (mockMmio{0x40057038})
+#define SIO_FIFO_ST                 (mockMmio{0xd0000050})
+#define SIO_FIFO_WR                 (mockMmio{0xd0000054})
+#define SIO_FIFO_RD                 (mockMmio{0xd0000058})
+#define XIP_FLUSH                   (mockMmio{0x14000004})
+
+// Everything runs from the same place on the host, barriers are instruction boundaries where interrupts are taken
+#define TIME_CRITICAL
+#define latencyBarrier()            mockBarrier()
+
+void mockBarrier();
+void mockUseTable(const irqHandler *table, bool flash);
+
+#endif
@@ -0,0 +1,106 @@
+#include <iostream>
+#include <iomanip>
+#include <map>
+
+#include "../clockTree.h"
+
+// Checks solvePll of clockTree.h against a brute force search over every REFDIV, FBDIV, POSTDIV1 and POSTDIV2
+// within the datasheet limits. Every frequency one of those combinations produces exactly is a target, which covers
+// every achievable clk_sys and clk_usb. The solver has to find the same configuration, with the lowest VCO, then
+// the highest POSTDIV1, then the lowest REFDIV, and must not find one for any other frequency.
+using namespace clockTree;
+
+static int failures;
+
+static bool sameConfig(const pllConfig &a, const pllConfig &b)
+{
+    return a.valid == b.valid && a.refDiv == b.refDiv && a.fbDiv == b.fbDiv && a.postDiv1 == b.postDiv1
+        && a.postDiv2 == b.postDiv2 && a.vcoHz == b.vcoHz;
+}
+
+static void report(uint64_t xoscHz, uint64_t targetHz, const char *what, const pllConfig &got)
+{
+    if (++failures > 20)
+        return;
+    std::cout << "    " << xoscHz << " Hz -> " << targetHz << " Hz: " << what << ", got refDiv " << got.refDiv << " fbDiv "
+              << got.fbDiv << " postDiv " << got.postDiv1 << " * " << got.postDiv2 << " VCO " << got.vcoHz << std::endl;
+}
+
+static void sweep(uint64_t xoscHz)
+{
+    // Best configuration per target, as the solver ranks them
+    std::map<uint64_t, pllConfig> best;
+    for (uint32_t refDiv = 1; refDiv <= refDivMax && xoscHz / refDiv >= refMinHz; ++refDiv)
+    {
+        for (uint32_t fbDiv = fbDivMin; fbDiv <= fbDivMax; ++fbDiv)
+        {
+            if ((xoscHz * fbDiv) % refDiv)
+                continue;
+            uint64_t vcoHz = xoscHz * fbDiv / refDiv;
+            if (vcoHz < vcoMinHz || vcoHz > vcoMaxHz)
+                continue;
+            for (uint32_t postDiv1 = 1; postDiv1 <= postDivMax; ++postDiv1)
+            {
+                for (uint32_t postDiv2 = 1; postDiv2 <= postDiv1; ++postDiv2)
+                {
+                    if (vcoHz % (postDiv1 * postDiv2))
+                        continue;
+                    uint64_t targetHz = vcoHz / (postDiv1 * postDiv2);
+                    pllConfig candidate = {true, refDiv, fbDiv, postDiv1, postDiv2, vcoHz};
+                    auto it = best.find(targetHz);
+                    if (it == best.end())
+                    {
+                        best[targetHz] = candidate;
+                        continue;
+                    }
+                    const pllConfig &current = it->second;
+                    if (vcoHz < current.vcoHz || (vcoHz == current.vcoHz && (postDiv1 > current.postDiv1
+                        || (postDiv1 == current.postDiv1 && refDiv < current.refDiv))))
+                        it->second = candidate;
+                }
+            }
+        }
+    }
+
+    uint32_t mismatches = 0;
+    for (const auto &[targetHz, expected] : best)
+    {
+        pllConfig got = solvePll(xoscHz, targetHz);
+        if (!sameConfig(got, expected))
+        {
+            report(xoscHz, targetHz, "differs from brute force", got);
+            ++mismatches;
+        }
+        else if (got.vcoHz < vcoMinHz || got.vcoHz > vcoMaxHz || pllOutHz(xoscHz, got) != targetHz)
+        {
+            report(xoscHz, targetHz, "VCO out of range or wrong output", got);
+            ++mismatches;
+        }
+
+        // The neighbours are only valid if they are achievable themselves
+        for (uint64_t neighbourHz : {targetHz - 1, targetHz + 1})
+        {
+            if (!best.count(neighbourHz) && solvePll(xoscHz, neighbourHz).valid)
+            {
+                report(xoscHz, neighbourHz, "solved but not achievable", solvePll(xoscHz, neighbourHz));
+                ++mismatches;
+            }
+        }
+    }
+
+    bool pass = !mismatches && best.count(48000000);
+    failures += !best.count(48000000);
+    std::cout << std::left << std::setw(12) << xoscHz << std::setw(8) << best.size() << "targets, "
+              << best.begin()->first << " - " << best.rbegin()->first << " Hz  " << (pass ? "ok" : "FAIL") << std::endl;
+}
+
+int main()
+{
+    std::cout << std::left << std::setw(12) << "XOSC Hz" << "Achievable frequencies" << std::endl;
+    for (uint64_t xoscHz : {12000000, 10000000, 16000000, 20000000, 25000000, 40000000})
+        sweep(xoscHz);
+
+    if (failures)
+        std::cout << failures << " check(s) failed. Exiting ..." << std::endl;
+    return failures ? 1 : 0;
+}
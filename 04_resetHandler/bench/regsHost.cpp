@@ -0,0 +1,119 @@
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <vector>
+
+#include "../regs_rp2040.h"
+
+// Host model of the bus, records every access of regs_rp2040.h and answers polls as if the hardware was ready
+struct busAccess
+{
+    bool write;
+    uint32_t addr, value;
+
+    bool operator==(const busAccess &other) const { return write == other.write && addr == other.addr && value == other.value; }
+};
+
+static std::vector<busAccess> accesses;
+static std::map<uint32_t, uint32_t> memory;
+
+// Status registers the code spins on, they read as all ones
+static const uint32_t readyAddrs[] =
+{
+    regs::resets::resetDone.addr, regs::xosc::status.addr, regs::pll::sys.cs.addr, regs::pll::usb.cs.addr,
+    regs::clocks::refSelected.addr, regs::clocks::sysSelected.addr,
+};
+
+uint32_t regs::busRead(uint32_t addr)
+{
+    uint32_t value = memory[addr];
+    for (uint32_t ready : readyAddrs)
+    {
+        if (addr == ready)
+            value = 0xffffffff;
+    }
+    accesses.push_back({false, addr, value});
+    return value;
+}
+
+void regs::busWrite(uint32_t addr, uint32_t value)
+{
+    accesses.push_back({true, addr, value});
+    uint32_t &reg = memory[addr & ~0x3000];
+    switch (addr & 0x3000)
+    {
+    case regs::aliasXor: reg ^= value; break;
+    case regs::aliasSet: reg |= value; break;
+    case regs::aliasClr: reg &= ~value; break;
+    default: reg = value; break;
+    }
+}
+
+extern "C" void flashTimingSetup(uint32_t clkSys) { (void)clkSys; }
+extern "C" void SystemInit();
+
+static int failures;
+
+static void check(const char *name, const std::vector<busAccess> &expected)
+{
+    bool pass = accesses == expected;
+    failures += !pass;
+    std::cout << std::left << std::setw(44) << name << (pass ? "ok" : "FAIL") << std::endl;
+    if (!pass)
+    {
+        for (const busAccess &access : accesses)
+            std::cout << "    " << (access.write ? "write " : "read  ") << std::hex << "0x" << access.addr << " 0x" << access.value << std::dec << std::endl;
+    }
+    accesses.clear();
+}
+
+int main()
+{
+    using namespace regs;
+
+    // Every bit update is a single store to the alias view, nothing is read
+    resets::reset.clear(resets::pllSys);
+    check("clear() stores to +0x3000", {{true, 0x4000f000, 1 << 12}});
+    timer::inte.set(1 << 3);
+    check("set() stores to +0x2000", {{true, 0x40056038, 1 << 3}});
+    timer::intf.toggle(1 << 1);
+    check("toggle() stores to +0x1000", {{true, 0x4005503c, 1 << 1}});
+
+    // SIO GPIO registers are written straight, the SET and XOR registers are write-only
+    sio::gpioOeSet.write(1 << 25);
+    sio::gpioOutXor.write(1 << 25);
+    check("SIO SET and XOR registers", {{true, 0xd0000024, 1 << 25}, {true, 0xd000001c, 1 << 25}});
+
+    // A field is replaced with a read and a flip of the differing bits only
+    memory[clocks::refCtrl.addr] = 0x00000101;
+    clocks::refCtrl.modify(clocks::ctrlSrc, clocks::refSrcXosc);
+    check("modify() reads and flips through +0x1000", {{false, 0x40008030, 0x101}, {true, 0x40009030, 0x3}});
+    if (memory[clocks::refCtrl.addr] != 0x00000102)
+    {
+        std::cout << "modify() left 0x" << std::hex << memory[clocks::refCtrl.addr] << std::dec << " FAIL" << std::endl;
+        ++failures;
+    }
+
+    resets::unreset(resets::timer);
+    check("unreset() clears and polls", {{true, 0x4000f000, 1 << 21}, {false, 0x4000c008, 0xffffffff}});
+
+    // The clock setup never reads a register it then writes back
+    memory.clear();
+    SystemInit();
+    uint32_t reads = 0, writes = 0, rmw = 0;
+    for (size_t i = 0; i < accesses.size(); ++i)
+    {
+        reads += !accesses[i].write;
+        writes += accesses[i].write;
+        if (i && accesses[i].write && !accesses[i - 1].write && accesses[i].addr == accesses[i - 1].addr)
+            ++rmw;
+    }
+    accesses.clear();
+    std::cout << std::left << std::setw(44) << "SystemInit without read-modify-write" << (rmw ? "FAIL" : "ok")
+              << "  " << reads << " reads, " << writes << " writes" << std::endl;
+    failures += rmw != 0;
+
+    if (failures)
+        std::cout << failures << " check(s) failed. Exiting ..." << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,504 @@
+#include <sstream>
+
+#include "ssiModel.h"
+
+// Instructions understood by the flash model
+#define CMD_WRITE_STATUS            (0x01)
+#define CMD_READ_DATA               (0x03)
+#define CMD_WRITE_DISABLE           (0x04)
+#define CMD_READ_STATUS1            (0x05)
+#define CMD_WRITE_ENABLE            (0x06)
+#define CMD_FAST_READ               (0x0b)
+#define CMD_READ_STATUS2            (0x35)
+#define CMD_FAST_READ_QUAD_OUT      (0x6b)
+#define CMD_FAST_READ_QUAD_IO       (0xeb)
+#define CMD_CONTINUOUS_RESET        (0xff)
+
+// Status register bits
+#define SR1_BUSY                    (1 << 0)
+#define SR1_WEL                     (1 << 1)
+#define SR2_QE                      (1 << 1)
+
+// SSI register offsets
+#define SSI_CTRLR0_OFFSET           (0x000)
+#define SSI_CTRLR1_OFFSET           (0x004)
+#define SSI_SSIENR_OFFSET           (0x008)
+#define SSI_BAUDR_OFFSET            (0x014)
+#define SSI_SR_OFFSET               (0x028)
+#define SSI_DR0_OFFSET              (0x060)
+#define SSI_RX_SAMPLE_DLY_OFFSET    (0x0f0)
+#define SSI_SPI_CTRLR0_OFFSET       (0x0f4)
+
+// Instruction length in bits for each INST_L value
+static const int instLength[] = {0, 4, 8, 16};
+
+static std::string hex(uint32_t value)
+{
+    std::ostringstream str;
+    str << std::hex << std::uppercase << value << "h";
+    return str.str();
+}
+
+flashModel::flashModel(bool qe)
+{
+    sr2 = qe ? SR2_QE : 0;
+}
+
+uint8_t flashModel::byteAt(uint32_t addr) const
+{
+    // Content is a hash of the address so that any misaligned read is caught
+    addr &= size - 1;
+    return (uint8_t)((addr * 2654435761u) >> 24);
+}
+
+void flashModel::warn(const std::string &msg)
+{
+    messages.push_back(msg);
+}
+
+void flashModel::csLow()
+{
+    cur = transaction();
+    if (continuous)
+    {
+        // Instruction is implied in continuous read mode, the first clock carries the address
+        startPhase(ADDR, 4, 24);
+        cur.addrLanes = 4;
+    }
+    else
+        startPhase(CMD, 1, 8);
+}
+
+void flashModel::startPhase(phaseType type, int laneCnt, int bitCnt_)
+{
+    phase = type;
+    lanes = laneCnt;
+    bits = bitCnt_;
+    bitCnt = 0;
+    shiftReg = 0;
+}
+
+void flashModel::command(uint8_t cmd)
+{
+    cur.cmd = cmd;
+
+    // Only status reads are accepted while a status register write is in progress
+    if (busy && cmd != CMD_READ_STATUS1 && cmd != CMD_READ_STATUS2)
+    {
+        warn("Instruction " + hex(cmd) + " ignored, Write Status Register still in progress (tW)");
+        startPhase(IGNORE, 1, 0);
+        return;
+    }
+
+    switch (cmd)
+    {
+    case CMD_READ_STATUS1:
+        outByte = sr1 | (busy ? SR1_BUSY : 0);
+        startPhase(STATUS_OUT, 1, 8);
+        break;
+    case CMD_READ_STATUS2:
+        outByte = sr2;
+        startPhase(STATUS_OUT, 1, 8);
+        break;
+    case CMD_WRITE_ENABLE:
+    case CMD_WRITE_DISABLE:
+    case CMD_CONTINUOUS_RESET:
+        startPhase(IGNORE, 1, 0); // Executed on CS high
+        break;
+    case CMD_WRITE_STATUS:
+        dataIn.clear();
+        startPhase(DATA_IN, 1, 8);
+        break;
+    case CMD_READ_DATA:
+    case CMD_FAST_READ:
+    case CMD_FAST_READ_QUAD_OUT:
+        startPhase(ADDR, 1, 24);
+        cur.addrLanes = 1;
+        break;
+    case CMD_FAST_READ_QUAD_IO:
+        startPhase(ADDR, 4, 24);
+        cur.addrLanes = 4;
+        break;
+    default:
+        warn("Unknown instruction " + hex(cmd));
+        startPhase(IGNORE, 1, 0);
+        break;
+    }
+
+    if ((cmd == CMD_FAST_READ_QUAD_OUT || cmd == CMD_FAST_READ_QUAD_IO) && !(sr2 & SR2_QE))
+    {
+        warn("Instruction " + hex(cmd) + " needs QE = 1, IO2 and IO3 are /WP and /HOLD");
+        startPhase(IGNORE, 1, 0);
+    }
+}
+
+void flashModel::endPhase()
+{
+    switch (phase)
+    {
+    case CMD:
+        command((uint8_t)shiftReg);
+        break;
+    case ADDR:
+        cur.addr = shiftReg;
+        readAddr = shiftReg;
+        if (cur.cmd == CMD_FAST_READ_QUAD_IO || cur.cmd == -1)
+            startPhase(MODE, 4, 8);
+        else if (cur.cmd == CMD_READ_DATA)
+            startPhase(DATA_OUT, 1, 8);
+        else
+            startPhase(DUMMY, 1, 8);
+        break;
+    case MODE:
+        cur.mode = shiftReg;
+        continuous = ((shiftReg & 0x30) == 0x20);
+        startPhase(DUMMY, 4, 4);
+        break;
+    case DUMMY:
+        startPhase(DATA_OUT, (cur.cmd == CMD_READ_DATA || cur.cmd == CMD_FAST_READ) ? 1 : 4, 8);
+        break;
+    case DATA_OUT:
+    case STATUS_OUT:
+        startPhase(phase, lanes, 8);
+        break;
+    case DATA_IN:
+        dataIn.push_back((uint8_t)shiftReg);
+        startPhase(DATA_IN, 1, 8);
+        break;
+    case IGNORE:
+        break;
+    }
+}
+
+flashModel::pins flashModel::clock(pins ssiOut)
+{
+    pins out = {0, 0};
+    cur.cycles++;
+
+    switch (phase)
+    {
+    case CMD:
+    case ADDR:
+    case MODE:
+    case DATA_IN:
+    {
+        // Undriven IOs are pulled high on the board
+        uint8_t in = (ssiOut.value & ssiOut.driven) | (~ssiOut.driven & 0xf);
+        uint8_t mask = (lanes == 1) ? 0x1 : 0xf;
+        if ((ssiOut.driven & mask) != mask)
+            warn("Flash sampled an undriven IO in " + std::string(phase == CMD ? "instruction" : phase == ADDR ? "address" : phase == MODE ? "mode" : "data") + " phase");
+        shiftReg = (shiftReg << lanes) | (in & mask);
+        bitCnt += lanes;
+        break;
+    }
+    case DUMMY:
+        cur.dummyCycles++;
+        bitCnt++;
+        break;
+    case DATA_OUT:
+    case STATUS_OUT:
+        if (bitCnt == 0 && phase == DATA_OUT)
+            outByte = byteAt(readAddr++);
+        if (lanes == 1)
+        {
+            out.value = ((outByte >> (7 - bitCnt)) & 1) << 1; // Standard SPI data out is on IO1
+            out.driven = 0x2;
+        }
+        else
+        {
+            out.value = (outByte >> (4 - bitCnt)) & 0xf;
+            out.driven = 0xf;
+        }
+        if (phase == DATA_OUT)
+        {
+            cur.dataCycles++;
+            cur.dataLanes = lanes;
+        }
+        bitCnt += lanes;
+        break;
+    case IGNORE:
+        bitCnt++;
+        break;
+    }
+
+    if (phase != IGNORE && bitCnt >= bits)
+        endPhase();
+    if (out.driven & ssiOut.driven)
+        warn("Bus contention, flash and SSI drive the same IO");
+    return out;
+}
+
+void flashModel::csHigh()
+{
+    // Write Enable/Disable are only executed if CS goes high right after the instruction
+    if (cur.cmd == CMD_WRITE_ENABLE || cur.cmd == CMD_WRITE_DISABLE)
+    {
+        if (cur.cycles == 8)
+            sr1 = (cur.cmd == CMD_WRITE_ENABLE) ? (sr1 | SR1_WEL) : (sr1 & ~SR1_WEL);
+        else
+            warn("Instruction " + hex(cur.cmd) + " ignored, CS was held low for " + std::to_string(cur.cycles) + " clocks instead of 8");
+    }
+    else if (cur.cmd == CMD_CONTINUOUS_RESET)
+        continuous = false;
+    else if (cur.cmd == CMD_WRITE_STATUS && phase != IGNORE)
+    {
+        if (!(sr1 & SR1_WEL))
+            warn("Write Status Register ignored, Write Enable Latch is not set");
+        else if (bitCnt != 0 || dataIn.empty() || dataIn.size() > 2)
+            warn("Write Status Register ignored, CS went high after " + std::to_string(cur.cycles) + " clocks");
+        else
+        {
+            sr1 = dataIn[0] & ~(SR1_BUSY | SR1_WEL);
+            if (dataIn.size() == 2)
+                sr2 = dataIn[1];
+            busy = true;
+        }
+    }
+    else if (phase == CMD || phase == ADDR || phase == MODE)
+    {
+        if (cur.cycles != 0)
+            warn("CS went high in the middle of instruction/address phase");
+    }
+
+    last = cur;
+    phase = IGNORE;
+}
+
+int ssiModel::frfLanes() const
+{
+    switch ((ctrlr0 >> 21) & 3)
+    {
+    case 1:
+        return 2;
+    case 2:
+        return 4;
+    default:
+        return 1;
+    }
+}
+
+std::vector<uint32_t> ssiModel::transfer(const std::vector<phase> &phases)
+{
+    std::vector<uint32_t> rx;
+
+    for (const phase &ph : phases)
+        clkSysCycles += (uint64_t)(ph.dummy ? ph.bits : ph.bits / ph.lanes) * (baudr ? baudr : 1);
+
+    flash.csLow();
+    for (const phase &ph : phases)
+    {
+        if (ph.dummy)
+        {
+            for (int cyc = 0; cyc < ph.bits; ++cyc)
+                flash.clock({0, 0});
+            continue;
+        }
+
+        uint32_t frame = 0;
+        uint8_t laneMask = (uint8_t)((1 << ph.lanes) - 1);
+        for (int bit = ph.bits - ph.lanes; bit >= 0; bit -= ph.lanes)
+        {
+            flashModel::pins ssiOut = {0, 0};
+            if (ph.out)
+            {
+                ssiOut.value = (ph.value >> bit) & laneMask;
+                ssiOut.driven = laneMask;
+            }
+            else if (ph.lanes == 1)
+            {
+                ssiOut.value = (ph.value >> bit) & 1; // Standard SPI sends TX data while receiving
+                ssiOut.driven = 0x1;
+            }
+
+            flashModel::pins in = flash.clock(ssiOut);
+            uint8_t sampled = in.value | (~in.driven & 0xf); // Undriven IOs are pulled high
+            frame = (frame << ph.lanes) | ((ph.lanes == 1) ? ((sampled >> 1) & 1) : (sampled & laneMask));
+        }
+        if (!ph.out)
+            rx.push_back(frame);
+    }
+    flash.csHigh();
+
+    return rx;
+}
+
+void ssiModel::flush()
+{
+    if (txFifo.empty())
+        return;
+
+    int tmod = (ctrlr0 >> 8) & 3;
+    int dfs = ((ctrlr0 >> 16) & 31) + 1;
+    std::vector<phase> phases;
+
+    if (frfLanes() == 1)
+    {
+        // Standard SPI, every TX frame is shifted out as is
+        for (uint32_t frame : txFifo)
+            phases.push_back({1, dfs, tmod != 0, false, frame}); // TX and RX mode samples while sending
+        if (tmod == 3)
+        {
+            for (uint32_t i = 0; i <= ctrlr1; ++i)
+                phases.push_back({1, dfs, false, false, 0});
+        }
+        std::vector<uint32_t> rx = transfer(phases);
+        if (tmod != 1)
+            rxFifo.insert(rxFifo.end(), rx.begin(), rx.end());
+    }
+    else
+    {
+        // Enhanced SPI, first TX entry is the instruction and the second one the address
+        int instBits = instLength[(spiCtrlr0 >> 8) & 3];
+        int addrBits = ((spiCtrlr0 >> 2) & 0xf) * 4;
+        int transType = spiCtrlr0 & 3;
+        size_t idx = 0;
+        if (instBits)
+            phases.push_back({transType == 2 ? frfLanes() : 1, instBits, true, false, txFifo[idx++]});
+        if (addrBits && idx < txFifo.size())
+            phases.push_back({transType == 0 ? 1 : frfLanes(), addrBits, true, false, txFifo[idx++]});
+        if ((spiCtrlr0 >> 11) & 0x1f)
+            phases.push_back({0, (int)((spiCtrlr0 >> 11) & 0x1f), false, true, 0});
+        for (uint32_t i = 0; i <= ctrlr1; ++i)
+            phases.push_back({frfLanes(), dfs, false, false, 0});
+        std::vector<uint32_t> rx = transfer(phases);
+        rxFifo.insert(rxFifo.end(), rx.begin(), rx.end());
+    }
+
+    txFifo.clear();
+}
+
+void ssiModel::write(uint32_t addr, uint32_t value)
+{
+    if (addr == 0xe000ed08)
+    {
+        vtor = value;
+        return;
+    }
+    if ((addr & ~0xfu) == 0xe000e010)
+        return; // SysTick always counts, see read()
+
+    switch (addr & 0xfff)
+    {
+    case SSI_SSIENR_OFFSET:
+        if (!(value & 1))
+        {
+            // Disabling the SSI clears both FIFOs and aborts a transfer in progress
+            if (!txFifo.empty())
+                messages.push_back("SSI disabled with " + std::to_string(txFifo.size()) + " frame(s) still in TX FIFO, transfer aborted");
+            txFifo.clear();
+            rxFifo.clear();
+        }
+        ssienr = value & 1;
+        break;
+    case SSI_CTRLR0_OFFSET:
+    case SSI_CTRLR1_OFFSET:
+    case SSI_BAUDR_OFFSET:
+    case SSI_RX_SAMPLE_DLY_OFFSET:
+    case SSI_SPI_CTRLR0_OFFSET:
+        if (ssienr)
+            break; // Configuration registers are read-only while SSI is enabled
+        if ((addr & 0xfff) == SSI_CTRLR0_OFFSET)
+            ctrlr0 = value;
+        else if ((addr & 0xfff) == SSI_CTRLR1_OFFSET)
+            ctrlr1 = value & 0xffff;
+        else if ((addr & 0xfff) == SSI_BAUDR_OFFSET)
+            baudr = value & 0xffff;
+        else if ((addr & 0xfff) == SSI_RX_SAMPLE_DLY_OFFSET)
+            rxSampleDly = value & 0xff;
+        else
+            spiCtrlr0 = value;
+        break;
+    case SSI_DR0_OFFSET:
+        if (ssienr)
+            txFifo.push_back(value);
+        break;
+    }
+}
+
+uint32_t ssiModel::read(uint32_t addr)
+{
+    // SysTick current value, counting down from 0xffffff with the time spent on the bus
+    if (addr == 0xe000e018)
+        return (0xffffff - clkSysCycles) & 0xffffff;
+
+    switch (addr & 0xfff)
+    {
+    case SSI_SR_OFFSET:
+        // Software can only see the end of a transfer by polling SR, frames pushed before that share one CS low period
+        flush();
+        return (1 << 1) | (1 << 2) | (rxFifo.empty() ? 0 : (1 << 3)); // TFNF, TFE, RFNE
+    case SSI_DR0_OFFSET:
+    {
+        flush();
+        if (rxFifo.empty())
+            return 0;
+        uint32_t value = rxFifo.front();
+        rxFifo.pop_front();
+        return value;
+    }
+    case SSI_CTRLR0_OFFSET:
+        return ctrlr0;
+    case SSI_SSIENR_OFFSET:
+        return ssienr;
+    case SSI_BAUDR_OFFSET:
+        return baudr;
+    case SSI_SPI_CTRLR0_OFFSET:
+        return spiCtrlr0;
+    default:
+        return 0;
+    }
+}
+
+int ssiModel::xipRead(uint32_t addr, int words, uint32_t *data)
+{
+    int instBits = instLength[(spiCtrlr0 >> 8) & 3];
+    int addrBits = ((spiCtrlr0 >> 2) & 0xf) * 4;
+    int transType = spiCtrlr0 & 3;
+    uint32_t xipCmd = spiCtrlr0 >> 24;
+    uint32_t flashAddr = addr & 0x00ffffff;
+    std::vector<phase> phases;
+
+    // XIP_CMD is the instruction if INST_L is non-zero, otherwise it is appended to the address as mode bits
+    if (instBits)
+        phases.push_back({transType == 2 ? frfLanes() : 1, instBits, true, false, xipCmd});
+    if (addrBits)
+        phases.push_back({transType == 0 ? 1 : frfLanes(), addrBits, true, false, (addrBits > 24 && !instBits) ? ((flashAddr << 8) | xipCmd) : flashAddr});
+    if ((spiCtrlr0 >> 11) & 0x1f)
+        phases.push_back({0, (int)((spiCtrlr0 >> 11) & 0x1f), false, true, 0});
+    for (int i = 0; i < words; ++i)
+        phases.push_back({frfLanes(), 32, false, false, 0});
+
+    int cycles = 0;
+    for (const phase &ph : phases)
+        cycles += ph.dummy ? ph.bits : ph.bits / ph.lanes;
+
+    std::vector<uint32_t> rx = transfer(phases);
+    for (int i = 0; i < words; ++i)
+    {
+        // XIP returns frames byte swapped so that the first byte from the flash lands at the lowest address
+        uint32_t frame = rx[rx.size() - words + i];
+        data[i] = __builtin_bswap32(frame);
+    }
+
+    return cycles;
+}
+
+#ifdef HOST_MODEL
+extern ssiModel *hostModel;
+
+hostMmio::operator uint32_t() const
+{
+    return hostModel->read(addr);
+}
+
+hostMmio &hostMmio::operator=(uint32_t value)
+{
+    hostModel->write(addr, value);
+    return *this;
+}
+
+void hostHandoff()
+{
+    throw boot2Handoff();
+}
+#endif
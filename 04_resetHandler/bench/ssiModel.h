@@ -0,0 +1,137 @@
+#ifndef SSI_MODEL_H
+#define SSI_MODEL_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+// Behavioral model of a W25Q80DV SPI NOR flash, clocked one SCK cycle at a time
+class flashModel
+{
+public:
+    // Pins IO0 - IO3 of the flash, bit n of a nibble is IOn
+    struct pins
+    {
+        uint8_t value;  // Level driven on each IO
+        uint8_t driven; // Mask of IOs being driven
+    };
+
+    // Everything the flash saw in one CS low period, used to check the command sequence
+    struct transaction
+    {
+        int cmd = -1;           // Instruction, -1 if the flash was in continuous read mode
+        uint32_t addr = 0;      // Address received
+        int addrLanes = 0;      // Number of IOs the address was received on
+        int mode = -1;          // Mode bits (EBh only)
+        int dummyCycles = 0;    // Dummy clocks seen
+        int dataCycles = 0;     // Clocks in data phase
+        int dataLanes = 0;      // Number of IOs used in data phase
+        int cycles = 0;         // Total clocks
+    };
+
+    static constexpr uint32_t size = 1024 * 1024; // W25Q80DV is 8Mbit
+
+    explicit flashModel(bool qe);
+
+    void csLow();
+    pins clock(pins ssiOut);
+    void csHigh();
+
+    uint8_t byteAt(uint32_t addr) const;
+    const transaction &lastTransaction() const { return last; }
+    const std::vector<std::string> &log() const { return messages; }
+
+private:
+    enum phaseType { CMD, ADDR, MODE, DUMMY, DATA_OUT, DATA_IN, STATUS_OUT, IGNORE };
+
+    void startPhase(phaseType type, int lanes, int bits);
+    void endPhase();
+    void command(uint8_t cmd);
+    void warn(const std::string &msg);
+
+    uint8_t sr1 = 0, sr2 = 0;   // Status registers, only BUSY/WEL and QE are modelled
+    bool continuous = false;    // EBh continuous read mode, M5-4 = 10
+    bool busy = false;          // Write Status Register in progress, ignored until reset of the model
+
+    phaseType phase = IGNORE;
+    int lanes = 1, bits = 0, bitCnt = 0;
+    uint32_t shiftReg = 0;
+    uint32_t readAddr = 0;
+    uint8_t outByte = 0;
+    std::vector<uint8_t> dataIn;
+    transaction cur, last;
+    std::vector<std::string> messages;
+};
+
+// Behavioral model of the RP2040 SSI (DW_apb_ssi) as seen by boot2 and the XIP controller
+class ssiModel
+{
+public:
+    explicit ssiModel(bool qe) : flash(qe) {}
+
+    void write(uint32_t addr, uint32_t value);
+    uint32_t read(uint32_t addr);
+
+    // Fetch words through XIP using the current SSI configuration, returns SCK cycles spent
+    int xipRead(uint32_t addr, int words, uint32_t *data);
+
+    const std::vector<std::string> &log() const { return messages; }
+
+    uint32_t vtor = 0;          // M0PLUS_VTOR written by boot2
+    uint64_t clkSysCycles = 0;  // clk_sys cycles spent clocking the flash, the only time the model accounts for
+    uint32_t baudr = 0;         // SSI_BAUDR
+    flashModel flash;
+
+private:
+    // Phase of a transfer as seen on the bus
+    struct phase
+    {
+        int lanes;          // Number of IOs used
+        int bits;           // Bits transferred, or clocks for a dummy phase
+        bool out;           // Driven by the SSI
+        bool dummy;         // Turnaround cycles, nobody drives the bus
+        uint32_t value;     // Data to send
+    };
+
+    void flush();
+    std::vector<uint32_t> transfer(const std::vector<phase> &phases);
+    int frfLanes() const;
+
+    // Registers start out as the bootrom leaves them, i.e. set up for Read Data (03h)
+    uint32_t ctrlr0 = 0x001f0300, ctrlr1 = 0, ssienr = 0, spiCtrlr0 = 0x03000218, rxSampleDly = 0;
+    std::deque<uint32_t> txFifo, rxFifo;
+    std::vector<std::string> messages;
+};
+
+#ifdef HOST_MODEL
+// Register proxy routing every access made by boot2 to the model
+struct hostMmio
+{
+    uint32_t addr;
+    operator uint32_t() const;
+    hostMmio &operator=(uint32_t value);
+};
+
+// Thrown when boot2 loads the stack pointer from the vector table, i.e. hands over to the application
+struct boot2Handoff {};
+[[noreturn]] void hostHandoff();
+
+// Register map used by the boot2 sources
+#define XIP_BASE                    (0x10000000)
+#define SSI_BASE                    (0x18000000)
+#define SSI_CTRLR0                  (hostMmio{SSI_BASE + 0x000})
+#define SSI_SSIENR                  (hostMmio{SSI_BASE + 0x008})
+#define SSI_BAUDR                   (hostMmio{SSI_BASE + 0x014})
+#define SSI_SR                      (hostMmio{SSI_BASE + 0x028})
+#define SSI_DR0                     (hostMmio{SSI_BASE + 0x060})
+#define SSI_SPI_CTRLR0              (hostMmio{SSI_BASE + 0x0f4})
+#define M0PLUS_BASE                 (0xe0000000)
+#define M0PLUS_VTOR                 (hostMmio{M0PLUS_BASE + 0xed08})
+
+// There is no Cortex-M0+ to jump to, the first inline assembly statement ends boot2
+#define asm(...)                    hostHandoff()
+#define naked                       noinline
+#endif
+
+#endif
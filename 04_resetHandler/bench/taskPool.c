@@ -0,0 +1,101 @@
+// On-target task pool benchmark, build with make benchTarget BENCH=taskPool
+// and read the results with a debugger once benchDone is set.
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../sections.h"
+#include "../taskPool_rp2040.h"
+#include "../timer_rp2040.h"
+
+#define CRC_BLOCKS                  (64)
+#define CRC_BLOCK_SIZE              (512)
+#define FIR_SAMPLES                 (8192)
+#define FIR_TAPS                    (8)
+
+#ifndef CLK_SYS_HZ
+#define CLK_SYS_HZ                  (100000000)
+#endif
+
+// Results in clk_sys cycles for the whole kernel, speedups in percent of the single core run
+volatile uint32_t crcCycles1, crcCycles2, crcSpeedup;
+volatile uint32_t firCycles1, firCycles2, firSpeedup;
+volatile bool benchDone;
+
+static uint8_t crcData[CRC_BLOCKS * CRC_BLOCK_SIZE];
+static uint32_t crcTable[256];
+static uint32_t blockCrcs[CRC_BLOCKS];
+
+static int16_t firIn[FIR_SAMPLES + FIR_TAPS - 1];
+static int16_t firOut[FIR_SAMPLES];
+static int16_t firCoefs[FIR_TAPS] = {3, 12, 28, 45, 45, 28, 12, 3};
+
+// Kernels and their tables live in SRAM, so the two cores do not fight over the XIP cache and only share the SRAM banks
+// CRC-32/MPEG-2 of every block, e.g. to check a flash image sector by sector
+TIME_CRITICAL static void crcKernel(uint32_t begin, uint32_t end, void *arg)
+{
+    (void)arg;
+    for (uint32_t block = begin; block < end; ++block)
+    {
+        const uint8_t *data = &crcData[block * CRC_BLOCK_SIZE];
+        uint32_t crc = 0xffffffff;
+        for (uint32_t i = 0; i < CRC_BLOCK_SIZE; ++i)
+            crc = (crc << 8) ^ crcTable[(crc >> 24) ^ data[i]];
+        blockCrcs[block] = crc;
+    }
+}
+
+// Low pass FIR filter, every output sample only depends on the input
+TIME_CRITICAL static void firKernel(uint32_t begin, uint32_t end, void *arg)
+{
+    (void)arg;
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        int32_t acc = 0;
+        for (uint32_t tap = 0; tap < FIR_TAPS; ++tap)
+            acc += firCoefs[tap] * firIn[i + tap];
+        firOut[i] = acc >> 8;
+    }
+}
+
+static uint32_t elapsedCycles(uint64_t start)
+{
+    return (readTime() - start) * (CLK_SYS_HZ / 1000000);
+}
+
+int main(void)
+{
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t crc = i << 24;
+        for (uint32_t bit = 0; bit < 8; ++bit)
+            crc = (crc << 1) ^ ((crc & 0x80000000) ? 0x04c11db7 : 0);
+        crcTable[i] = crc;
+    }
+    uint32_t seed = 1;
+    for (uint32_t i = 0; i < sizeof(crcData); ++i)
+        crcData[i] = (seed = seed * 1664525 + 1013904223) >> 24;
+    for (uint32_t i = 0; i < sizeof(firIn) / sizeof(firIn[0]); ++i)
+        firIn[i] = (seed = seed * 1664525 + 1013904223) >> 16;
+
+    taskPoolStart();
+
+    uint64_t start = readTime();
+    crcKernel(0, CRC_BLOCKS, 0);
+    crcCycles1 = elapsedCycles(start);
+    start = readTime();
+    parallelFor(0, CRC_BLOCKS, 2, crcKernel, 0);
+    crcCycles2 = elapsedCycles(start);
+    crcSpeedup = 100 * crcCycles1 / crcCycles2;
+
+    start = readTime();
+    firKernel(0, FIR_SAMPLES, 0);
+    firCycles1 = elapsedCycles(start);
+    start = readTime();
+    parallelFor(0, FIR_SAMPLES, 256, firKernel, 0);
+    firCycles2 = elapsedCycles(start);
+    firSpeedup = 100 * firCycles1 / firCycles2;
+
+    benchDone = true;
+    while (true)
+        asm volatile ("wfi");
+}
@@ -0,0 +1,121 @@
+// On-target XIP cache benchmark, build with make benchTarget BENCH=xipCache
+// and read the results with a debugger once benchDone is set.
+//
+// A CRC kernel in SRAM looks up its table in flash, so only the table goes through the XIP cache. Every case
+// prepares the cache, then runs the kernel with the cache counters cleared right before and read right after.
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../sections.h"
+#include "../timer_rp2040.h"
+#include "../xip_rp2040.h"
+
+#define DATA_SIZE                   (4096)
+#define RUNS                        (100)
+
+// Flash well past the image, streamed through the cache to evict everything that is not pinned
+#define EVICT_START                 ((const void *)0x10100000)
+#define EVICT_SIZE                  (2 * XIP_CACHE_SIZE)
+
+#ifndef CLK_SYS_HZ
+#define CLK_SYS_HZ                  (100000000)
+#endif
+
+enum
+{
+    XIP_CASE_COLD,          // Right after a flush
+    XIP_CASE_WARM,          // Table left in the cache by the previous run
+    XIP_CASE_PREFETCHED,    // Flushed, then the table prefetched
+    XIP_CASE_EVICTED,       // Table cached, then evicted by other flash traffic
+    XIP_CASE_PINNED,        // Table pinned, then the same flash traffic
+    XIP_CASES
+};
+
+typedef struct
+{
+    uint32_t hits, accesses;    // Of the last run
+    uint32_t cycles;            // clk_sys cycles per run, averaged over RUNS
+} xipCaseResult;
+
+volatile xipCaseResult xipResults[XIP_CASES];
+volatile bool benchDone;
+
+static uint8_t data[DATA_SIZE];
+
+// CRC-32/MPEG-2 table, const so it stays in flash
+static const uint32_t crcTable[256] =
+{
+#define CRC_ENTRY(i)    CRC_BIT(CRC_BIT(CRC_BIT(CRC_BIT(CRC_BIT(CRC_BIT(CRC_BIT(CRC_BIT((uint32_t)(i) << 24))))))))
+#define CRC_BIT(c)      (((c) << 1) ^ (0x04c11db7 & -((c) >> 31)))
+#define CRC_ROW(i)      CRC_ENTRY(i), CRC_ENTRY(i + 1), CRC_ENTRY(i + 2), CRC_ENTRY(i + 3), \
+                        CRC_ENTRY(i + 4), CRC_ENTRY(i + 5), CRC_ENTRY(i + 6), CRC_ENTRY(i + 7)
+#define CRC_BLOCK(i)    CRC_ROW(i), CRC_ROW(i + 8), CRC_ROW(i + 16), CRC_ROW(i + 24)
+    CRC_BLOCK(0), CRC_BLOCK(32), CRC_BLOCK(64), CRC_BLOCK(96),
+    CRC_BLOCK(128), CRC_BLOCK(160), CRC_BLOCK(192), CRC_BLOCK(224)
+};
+
+static volatile uint32_t crcResult;
+
+TIME_CRITICAL static void crcKernel(void)
+{
+    uint32_t crc = 0xffffffff;
+    for (uint32_t i = 0; i < DATA_SIZE; ++i)
+        crc = (crc << 8) ^ crcTable[(crc >> 24) ^ data[i]];
+    crcResult = crc;
+}
+
+static void measure(uint32_t xipCase)
+{
+    uint64_t total = 0;
+    xipCounters counters = {0, 0};
+    for (uint32_t run = 0; run < RUNS; ++run)
+    {
+        switch (xipCase)
+        {
+        case XIP_CASE_COLD:
+            xipCacheFlush();
+            break;
+        case XIP_CASE_WARM:
+            crcKernel();
+            break;
+        case XIP_CASE_PREFETCHED:
+            xipCacheFlush();
+            xipCachePrefetch(crcTable, sizeof(crcTable));
+            break;
+        case XIP_CASE_EVICTED:
+            crcKernel();
+            xipCachePrefetch(EVICT_START, EVICT_SIZE);
+            break;
+        case XIP_CASE_PINNED:
+            xipCacheFlush();
+            xipCachePin(crcTable, sizeof(crcTable));
+            xipCachePrefetch(EVICT_START, EVICT_SIZE);
+            break;
+        }
+
+        uint64_t start = readTime();
+        xipCountersReset();
+        crcKernel();
+        counters = xipCountersRead();
+        total += readTime() - start;
+    }
+    xipCacheFlush(); // Unpin
+
+    xipResults[xipCase].hits = counters.hits;
+    xipResults[xipCase].accesses = counters.accesses;
+    xipResults[xipCase].cycles = total * (CLK_SYS_HZ / 1000000) / RUNS;
+}
+
+int main(void)
+{
+    uint32_t seed = 1;
+    for (uint32_t i = 0; i < DATA_SIZE; ++i)
+        data[i] = (seed = seed * 1664525 + 1013904223) >> 24;
+
+    for (uint32_t xipCase = 0; xipCase < XIP_CASES; ++xipCase)
+        measure(xipCase);
+
+    benchDone = true;
+    while (true)
+        asm volatile ("wfi");
+}
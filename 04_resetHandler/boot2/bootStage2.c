@@ -2,6 +2,9 @@
 #include <stdbool.h>
 
 // Define necessary register addresses
+#ifdef HOST_MODEL
+#include "ssiModel.h" // Registers are routed to the host-side SSI and flash model in ../bench
+#else
 // XIP
 #define XIP_BASE                    (0x10000000)
 // SSI
@@ -13,6 +16,9 @@
 // M0PLUS
 #define M0PLUS_BASE                 (0xe0000000)
 #define M0PLUS_VTOR                 (*(volatile uint32_t *) (M0PLUS_BASE + 0xed08))
+#endif
+
+#include "../bootTrace.h" // Boot phase probes, compiled in with BOOT_TRACE
 
 // A brief list of steps to take
 // 1. Setup IO_QSPI pins for XIP
@@ -22,6 +28,9 @@
 // Boot stage 2 entry point
 __attribute__((naked, noreturn, section(".boot2"))) void bootStage2(void)
 {
+    bootTraceStartAsm(); // Start the cycle counter for the boot phase timeline
+    bootTraceAsm(BOOT_TRACE_BOOT2_START);
+
     // 1. Setup IO_QSPI pins for XIP (already done by bootrom)
     //  - Bring IO_QSPI out of reset state
     //  - Set SCLK and SS to OE
@@ -37,6 +46,8 @@ __attribute__((naked, noreturn, section(".boot2"))) void bootStage2(void)
     // 3. Enable XIP Cache
     // It is enabled by default. Take a look at https://datasheets.raspberrypi.com/rp2040/rp2040-datasheet.pdf#page=128
 
+    bootTraceAsm(BOOT_TRACE_BOOT2_XIP);
+
     // Mimic non-rp2040 arm microcontroller behavior
     // 1. Set correct VTOR value
     M0PLUS_VTOR = XIP_BASE + 0x100; // Start of flash + boot stage 2 size
@@ -2,6 +2,9 @@
 #include <stdbool.h>
 
 // Define necessary register addresses
+#ifdef HOST_MODEL
+#include "ssiModel.h" // Registers are routed to the host-side SSI and flash model in ../bench
+#else
 // XIP
 #define XIP_BASE                    (0x10000000)
 // SSI
@@ -15,6 +18,9 @@
 // M0PLUS
 #define M0PLUS_BASE                 (0xe0000000)
 #define M0PLUS_VTOR                 (*(volatile uint32_t *) (M0PLUS_BASE + 0xed08))
+#endif
+
+#include "../bootTrace.h" // Boot phase probes, compiled in with BOOT_TRACE
 
 // A brief list of steps to take
 // 1. Setup IO_QSPI pins for XIP
@@ -24,6 +30,9 @@
 // Boot stage 2 entry point
 __attribute__((section(".boot2"))) void bootStage2(void)
 {
+    bootTraceStart(); // Start the cycle counter for the boot phase timeline
+    bootTrace(BOOT_TRACE_BOOT2_START, BOOT_TRACE_ROSC);
+
     // 1. Setup IO_QSPI pins for XIP (already done by bootrom)
     //  - Bring IO_QSPI out of reset state
     //  - Set SCLK and SS to OE
@@ -67,6 +76,8 @@ __attribute__((section(".boot2"))) void bootStage2(void)
     // 3. Enable XIP Cache
     // It is enabled by default. Take a look at https://datasheets.raspberrypi.com/rp2040/rp2040-datasheet.pdf#page=128
 
+    bootTrace(BOOT_TRACE_BOOT2_XIP, BOOT_TRACE_ROSC);
+
     // Mimic non-rp2040 arm microcontroller behavior
     // 1. Set correct VTOR value
     M0PLUS_VTOR = XIP_BASE + 0x100; // Start of flash + boot stage 2 size
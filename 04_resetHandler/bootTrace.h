@@ -0,0 +1,135 @@
+#ifndef BOOT_TRACE_H
+#define BOOT_TRACE_H
+
+#include <stdint.h>
+
+// Boot phases, each probe marks the end of the phase that started at the probe before it
+#define BOOT_TRACE_BOOT2_START          (0)     // boot2 entered, the cycle counter starts here
+#define BOOT_TRACE_BOOT2_XIP            (1)     // SSI set up for XIP, about to jump to resetHandler
+#define BOOT_TRACE_RESET_HANDLER        (2)     // resetHandler entered
+#define BOOT_TRACE_DATA_INIT            (3)     // .data copied and .bss zeroed
+#define BOOT_TRACE_XOSC_STABLE          (4)     // XOSC started and stable
+#define BOOT_TRACE_PLL_LOCKED           (5)     // PLL_SYS locked
+#define BOOT_TRACE_CLK_REF_SWITCHED     (6)     // clk_ref running from XOSC
+#define BOOT_TRACE_CLK_SYS_SWITCHED     (7)     // clk_sys running from PLL_SYS
+#define BOOT_TRACE_FLASH_RETUNED        (8)     // SSI clock divider and RX sample delay retuned
+#define BOOT_TRACE_TIMER_STARTED        (9)     // TIMER out of reset, recorded with both clocks to join them
+#define BOOT_TRACE_MAIN                 (10)    // Constructors done, about to call main
+
+// Clock a timestamp was taken with
+#define BOOT_TRACE_ROSC                 (0)     // SysTick elapsed cycles, CPU running from ROSC
+#define BOOT_TRACE_CLK_SYS              (1)     // SysTick elapsed cycles, CPU running from PLL_SYS
+#define BOOT_TRACE_TIMER                (2)     // TIMER microseconds
+
+#define BOOT_TRACE_MAGIC                (0x63617254) // "Trac"
+#define BOOT_TRACE_SIZE                 (32)    // Number of records, must be a power of 2
+
+typedef struct
+{
+    uint32_t info;      // Phase in bits 15:0, clock in bits 31:16
+    uint32_t stamp;     // Elapsed SysTick cycles (24-bit) or TIMER microseconds (32-bit)
+} bootTraceRecord;
+
+// Ring buffer in .noinit, neither the C runtime nor a warm reset clears it so it can be dumped afterwards
+typedef struct
+{
+    uint32_t magic;
+    uint32_t count;     // Records written since boot2 started, the latest BOOT_TRACE_SIZE are kept
+    bootTraceRecord records[BOOT_TRACE_SIZE];
+} bootTraceBuffer;
+
+#ifdef BOOT_TRACE
+#ifdef HOST_MODEL
+// SysTick is emulated by the host-side SSI model in ../bench, it counts the clk_sys cycles spent on the flash bus
+#define BOOT_TRACE_SYST_CSR             (hostMmio{0xe000e010})
+#define BOOT_TRACE_SYST_RVR             (hostMmio{0xe000e014})
+#define BOOT_TRACE_SYST_CVR             (hostMmio{0xe000e018})
+#define BOOT_TRACE_TIMER_TIMERAWL       (hostMmio{0x40054028})
+#else
+#define BOOT_TRACE_SYST_CSR             (*(volatile uint32_t *) (0xe000e010))
+#define BOOT_TRACE_SYST_RVR             (*(volatile uint32_t *) (0xe000e014))
+#define BOOT_TRACE_SYST_CVR             (*(volatile uint32_t *) (0xe000e018))
+#define BOOT_TRACE_TIMER_TIMERAWL       (*(volatile uint32_t *) (0x40054028))
+#endif
+
+#ifdef __cplusplus
+extern "C" bootTraceBuffer bootTraceBuf;
+#else
+extern bootTraceBuffer bootTraceBuf;
+#endif
+
+// Start a new trace, called first thing in boot2 as nothing has set up SysTick before
+static inline __attribute__((always_inline)) void bootTraceStart(void)
+{
+    BOOT_TRACE_SYST_RVR = 0xffffff; // Count down from the largest value
+    BOOT_TRACE_SYST_CVR = 0; // Clear current value, it is reloaded on the first tick
+    BOOT_TRACE_SYST_CSR = (1 << 2) | (1 << 0); // Count processor clock cycles, no interrupt
+    bootTraceBuf.magic = BOOT_TRACE_MAGIC;
+    bootTraceBuf.count = 0;
+}
+
+// Record the end of a phase, inlined so it works before XIP is set up and costs a handful of instructions
+static inline __attribute__((always_inline)) void bootTrace(uint32_t phase, uint32_t clock)
+{
+    uint32_t stamp = (clock == BOOT_TRACE_TIMER) ? (uint32_t)BOOT_TRACE_TIMER_TIMERAWL : (0xffffff - BOOT_TRACE_SYST_CVR);
+    bootTraceRecord *rec = &bootTraceBuf.records[bootTraceBuf.count++ & (BOOT_TRACE_SIZE - 1)];
+    rec->info = phase | (clock << 16);
+    rec->stamp = stamp;
+    __asm__ volatile ("" ::: "memory"); // Keep the record ahead of whatever the next phase does, e.g. the jump out of boot2
+}
+
+// The same probes for the naked bootStage2.c, where the compiler supports nothing but basic asm. They start the
+// trace and record a BOOT_TRACE_ROSC stamp with the stores of the versions above, r0 - r3 are kept on the bootrom
+// stack as the compiler cannot be told they are used.
+#ifdef HOST_MODEL
+#define bootTraceStartAsm()             bootTraceStart()
+#define bootTraceAsm(phase)             bootTrace(phase, BOOT_TRACE_ROSC)
+#else
+#define BOOT_TRACE_STR(x)               #x
+#define BOOT_TRACE_XSTR(x)              BOOT_TRACE_STR(x)
+
+#define bootTraceStartAsm()                                                                                         \
+    __asm__ volatile (                                                                                              \
+        "   push {r0, r1}               \n"                                                                         \
+        "   ldr r0, =0xe000e010         \n" /* SYST_CSR */                                                          \
+        "   ldr r1, =0xffffff           \n"                                                                         \
+        "   str r1, [r0, #4]            \n" /* SYST_RVR, count down from the largest value */                       \
+        "   movs r1, #0                 \n"                                                                         \
+        "   str r1, [r0, #8]            \n" /* SYST_CVR, reloaded on the first tick */                              \
+        "   movs r1, #5                 \n"                                                                         \
+        "   str r1, [r0, #0]            \n" /* Count processor clock cycles, no interrupt */                        \
+        "   ldr r0, =bootTraceBuf       \n"                                                                         \
+        "   ldr r1, =" BOOT_TRACE_XSTR(BOOT_TRACE_MAGIC) "\n"                                                        \
+        "   str r1, [r0, #0]            \n" /* magic */                                                             \
+        "   movs r1, #0                 \n"                                                                         \
+        "   str r1, [r0, #4]            \n" /* count */                                                             \
+        "   pop {r0, r1}                \n")
+
+#define bootTraceAsm(phase)                                                                                         \
+    __asm__ volatile (                                                                                              \
+        "   push {r0, r1, r2, r3}       \n"                                                                         \
+        "   ldr r0, =0xe000e010         \n" /* SYST_CSR */                                                          \
+        "   ldr r1, [r0, #8]            \n" /* SYST_CVR */                                                          \
+        "   ldr r2, =0xffffff           \n"                                                                         \
+        "   subs r1, r2, r1             \n" /* stamp, elapsed cycles */                                             \
+        "   ldr r0, =bootTraceBuf       \n"                                                                         \
+        "   ldr r2, [r0, #4]            \n" /* count */                                                             \
+        "   adds r3, r2, #1             \n"                                                                         \
+        "   str r3, [r0, #4]            \n"                                                                         \
+        "   movs r3, #(" BOOT_TRACE_XSTR(BOOT_TRACE_SIZE) " - 1)\n"                                                  \
+        "   ands r2, r3                 \n"                                                                         \
+        "   lsls r2, r2, #3             \n" /* Records are 8 bytes and start at offset 8 */                         \
+        "   adds r2, r0, r2             \n"                                                                         \
+        "   movs r3, #" BOOT_TRACE_XSTR(phase) "\n"                                                                  \
+        "   str r3, [r2, #8]            \n" /* info, the clock is BOOT_TRACE_ROSC = 0 */                            \
+        "   str r1, [r2, #12]           \n" /* stamp */                                                             \
+        "   pop {r0, r1, r2, r3}        \n")
+#endif
+#else
+#define bootTraceStart()
+#define bootTrace(phase, clock)
+#define bootTraceStartAsm()
+#define bootTraceAsm(phase)
+#endif
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef CLOCK_TREE_H
+#define CLOCK_TREE_H
+
+#include <stdint.h>
+
+// Compile-time PLL divider solver, FOUTPOSTDIV = (FREF / REFDIV) * FBDIV / (POSTDIV1 * POSTDIV2)
+namespace clockTree
+{
+    // Limits from the PLL section of the RP2040 datasheet
+    constexpr uint64_t refMinHz = 5000000;
+    constexpr uint64_t vcoMinHz = 750000000;
+    constexpr uint64_t vcoMaxHz = 1600000000;
+    constexpr uint32_t refDivMax = 63;
+    constexpr uint32_t fbDivMin = 16, fbDivMax = 320;
+    constexpr uint32_t postDivMax = 7;
+
+    struct pllConfig
+    {
+        bool valid;
+        uint32_t refDiv, fbDiv, postDiv1, postDiv2;
+        uint64_t vcoHz;
+    };
+
+    // Exact solution with the lowest VCO frequency, as it draws the least power, then the highest POSTDIV1
+    // and the lowest REFDIV. The result is invalid if no combination hits the target exactly.
+    constexpr pllConfig solvePll(uint64_t xoscHz, uint64_t targetHz)
+    {
+        pllConfig best = {false, 0, 0, 0, 0, 0};
+        for (uint32_t postDiv1 = postDivMax; postDiv1 >= 1; --postDiv1)
+        {
+            // POSTDIV2 is kept at or below POSTDIV1, the other way round only costs power
+            for (uint32_t postDiv2 = postDiv1; postDiv2 >= 1; --postDiv2)
+            {
+                uint64_t vcoHz = targetHz * postDiv1 * postDiv2;
+                if (vcoHz < vcoMinHz || vcoHz > vcoMaxHz || (best.valid && vcoHz >= best.vcoHz))
+                    continue;
+                for (uint32_t refDiv = 1; refDiv <= refDivMax && xoscHz / refDiv >= refMinHz; ++refDiv)
+                {
+                    if ((vcoHz * refDiv) % xoscHz)
+                        continue;
+                    uint64_t fbDiv = vcoHz * refDiv / xoscHz;
+                    if (fbDiv < fbDivMin || fbDiv > fbDivMax)
+                        continue;
+                    best = {true, refDiv, (uint32_t)fbDiv, postDiv1, postDiv2, vcoHz};
+                    break;
+                }
+            }
+        }
+        return best;
+    }
+
+    // Frequency a configuration actually produces
+    constexpr uint64_t pllOutHz(uint64_t xoscHz, const pllConfig &pll)
+    {
+        return xoscHz * pll.fbDiv / pll.refDiv / (pll.postDiv1 * pll.postDiv2);
+    }
+
+    // Known good configurations, checked whenever this header is compiled
+    static_assert(solvePll(12000000, 125000000).vcoHz == 750000000 && solvePll(12000000, 125000000).postDiv1 == 6, "PLL solver is broken");
+    static_assert(solvePll(12000000, 133000000).fbDiv == 133 && solvePll(12000000, 133000000).refDiv == 2, "PLL solver is broken");
+    static_assert(solvePll(12000000, 48000000).vcoHz == 768000000, "PLL solver is broken");
+    static_assert(!solvePll(12000000, 133333333).valid, "PLL solver is broken");
+}
+
+#endif
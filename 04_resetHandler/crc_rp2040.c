@@ -0,0 +1,122 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "crc_rp2040.h"
+#include "dma_rp2040.h"
+
+// Define necessary register addresses
+// XIP aliases, the same flash seen through different cache behavior
+#define XIP_BASE                    (0x10000000)    // Cached, allocating
+#define XIP_NOCACHE_NOALLOC_BASE    (0x13000000)    // Bypasses the cache
+#define XIP_CTRL_BASE               (0x14000000)    // End of the aliases
+#define XIP_OFFSET_MASK             (0x00ffffff)
+
+#define CRC32_MPEG2_POLY            (0x04c11db7)
+
+static int32_t crcChannel = -1;         // Claimed by the first CRC and kept
+static uint32_t crcSink;                // The words only pass by the sniffer on their way here
+static const uint8_t *crcWordData;      // Whole words, run through the sniffer
+static uint32_t crcWords;
+static const uint8_t *crcTail;          // Bytes after the last whole word, folded in on the CPU
+static uint32_t crcTailLen;
+static crcCallback crcDoneCallback;
+static void *crcDoneArg;
+
+// Bitwise on the CPU, for the few bytes the sniffer does not see and whenever it is taken
+static uint32_t crcBytes(uint32_t crc, const uint8_t *data, uint32_t len)
+{
+    for (; len; ++data, --len)
+    {
+        crc ^= (uint32_t)*data << 24;
+        for (uint32_t bit = 0; bit < 8; ++bit)
+            crc = (crc << 1) ^ (CRC32_MPEG2_POLY & -(crc >> 31));
+    }
+    return crc;
+}
+
+// Flash is read through the alias that neither looks up nor fills the cache
+static const void *aroundCache(const uint8_t *data)
+{
+    uintptr_t addr = (uintptr_t)data;
+    if (addr >= XIP_BASE && addr < XIP_CTRL_BASE)
+        return (const void *)(XIP_NOCACHE_NOALLOC_BASE | (addr & XIP_OFFSET_MASK));
+    return data;
+}
+
+static uint32_t crcFinish(void)
+{
+    uint32_t crc = crcBytes(dmaSniffResult(), crcTail, crcTailLen);
+    dmaSniffRelease();
+    return crc;
+}
+
+static void crcDone(uint32_t channel, void *arg)
+{
+    (void)channel;
+    (void)arg;
+    crcCallback callback = crcDoneCallback;
+    void *callbackArg = crcDoneArg;
+    uint32_t crc = crcFinish(); // Frees the sniffer, the callback may start the next CRC
+    if (callback)
+        callback(crc, callbackArg);
+}
+
+// Take the sniffer and a channel, fold the bytes up to the first word boundary into crc and seed the sniffer with
+// it. The whole words are left for crcTransfer and the bytes after them for crcFinish. Returns false with nothing
+// taken if the sniffer or a channel is not free.
+static bool crcSetup(uint32_t crc, const void *data, uint32_t len)
+{
+    if (!dmaSniffClaim())
+        return false;
+    if (crcChannel < 0)
+        crcChannel = dmaClaim(); // Only ever done with the sniffer held, so by one caller at a time
+    if (crcChannel < 0)
+    {
+        dmaSniffRelease();
+        return false;
+    }
+
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint32_t head = -(uintptr_t)bytes & 3;
+    if (head > len)
+        head = len;
+    crcWordData = bytes + head;
+    crcWords = (len - head) / 4;
+    crcTail = crcWordData + 4 * crcWords;
+    crcTailLen = len - head - 4 * crcWords;
+    dmaSniffStart(crcChannel, DMA_SNIFF_CRC32, true, crcBytes(crc, bytes, head));
+    return true;
+}
+
+// Word reads take a quarter of the bus transfers of byte reads. The sniffer takes a word most significant bit first,
+// the byte swap set up in crcSetup turns the little-endian word back into the order of its bytes in memory.
+static void crcTransfer(dmaCallback callback)
+{
+    dmaStart(crcChannel, aroundCache(crcWordData), &crcSink, crcWords, DMA_SIZE_WORD | DMA_INCR_READ | DMA_SNIFF | DMA_TREQ(DREQ_PERMANENT),
+             callback, 0);
+}
+
+uint32_t crcUpdate(uint32_t crc, const void *data, uint32_t len)
+{
+    if (!crcSetup(crc, data, len))
+        return crcBytes(crc, (const uint8_t *)data, len);
+    if (crcWords)
+    {
+        crcTransfer(0);
+        dmaWait(crcChannel);
+    }
+    return crcFinish();
+}
+
+bool crcStart(uint32_t crc, const void *data, uint32_t len, crcCallback callback, void *arg)
+{
+    if (!crcSetup(crc, data, len))
+        return false;
+    crcDoneCallback = callback;
+    crcDoneArg = arg;
+    if (crcWords)
+        crcTransfer(crcDone);
+    else
+        crcDone((uint32_t)-1, 0);
+    return true;
+}
@@ -0,0 +1,35 @@
+#ifndef CRC_RP2040_H
+#define CRC_RP2040_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// CRC-32/MPEG-2 computed by the DMA sniffer: polynomial 0x04c11db7, initial value 0xffffffff, no reflection and no
+// final XOR. The same CRC as tools/crc32Mpeg2.h, so a checksum calculated on the host is compared as is.
+#define CRC_INIT                    (0xffffffff)
+
+// Called in the DMA interrupt of the calling core with the finished CRC
+typedef void (*crcCallback)(uint32_t crc, void *arg);
+
+// Continue crc over len bytes at data, in SRAM or flash. Flash is read around the XIP cache, so checking a whole
+// image does not evict the code. Blocks until done, falls back to the CPU if the sniffer is in use.
+uint32_t crcUpdate(uint32_t crc, const void *data, uint32_t len);
+
+static inline uint32_t crcCalculate(const void *data, uint32_t len)
+{
+    return crcUpdate(CRC_INIT, data, len);
+}
+
+// Same as crcUpdate but returns right away, false if the sniffer or a channel is not free. data must be left
+// alone until the callback, which may already have run when this returns.
+bool crcStart(uint32_t crc, const void *data, uint32_t len, crcCallback callback, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,215 @@
+// Integer division libcalls on the SIO hardware divider. The M0+ has no divide instruction, so GCC turns every
+// / and % into a call to one of the run-time ABI functions below, which libgcc otherwise implements as a shift
+// and subtract loop. The divider of each core takes 8 cycles, these run from SRAM next to the code that needs them.
+//
+// The divider holds the operands and results of one division at a time. An interrupt may arrive in the middle of
+// a division, so every user checks the DIRTY flag first: set, it lets the pending division finish, saves all four
+// registers and puts them back when done. The interrupted code then reads the result it was waiting for.
+// Reading QUOTIENT last clears the flag, so code that is not interrupted never pays for the save.
+//
+// 64-bit divisions go through the divider while the divisor fits 16 bits, larger ones are left to libgcc.
+// Division by zero returns what __aeabi_idiv0 and __aeabi_ldiv0 return, as the libgcc versions do.
+// make HWDIV=0 links the libgcc versions instead, e.g. to compare with make benchTarget BENCH=divider.
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sections.h"
+
+// Define necessary register addresses
+// SIO, each core sees its own divider
+#define SIO_DIV_UDIVIDEND           (*(volatile uint32_t *) (0xd0000060))
+#define SIO_DIV_UDIVISOR            (*(volatile uint32_t *) (0xd0000064))
+#define SIO_DIV_SDIVIDEND           (*(volatile uint32_t *) (0xd0000068))
+#define SIO_DIV_SDIVISOR            (*(volatile uint32_t *) (0xd000006c))
+#define SIO_DIV_QUOTIENT            (*(volatile uint32_t *) (0xd0000070))
+#define SIO_DIV_REMAINDER           (*(volatile uint32_t *) (0xd0000074))
+#define SIO_DIV_CSR                 (*(volatile uint32_t *) (0xd0000078))
+
+#define SIO_DIV_CSR_DIRTY           (1 << 1)
+
+typedef struct
+{
+    uint32_t dividend, divisor;
+    uint32_t remainder, quotient;
+} dividerState;
+
+// Division by zero hooks of the run-time ABI, libgcc provides defaults returning their argument
+int __aeabi_idiv0(int value);
+long long __aeabi_ldiv0(long long value);
+
+// libgcc's 64-bit division, for divisors too wide for the divider
+uint64_t __udivmoddi4(uint64_t n, uint64_t d, uint64_t *rem);
+
+// The result is ready 8 cycles after the divisor is written, four taken branches of 2 cycles each
+static inline void dividerWait(void)
+{
+    asm volatile (
+        "   b 1f                        \n"
+        "1: b 1f                        \n"
+        "1: b 1f                        \n"
+        "1: b 1f                        \n"
+        "1:                             \n" ::: "memory");
+}
+
+// Returns true with the state of an interrupted division in state, which dividerRestore has to put back
+static inline bool dividerSave(dividerState *state)
+{
+    if (!(SIO_DIV_CSR & SIO_DIV_CSR_DIRTY))
+        return false;
+    dividerWait(); // The interrupted division may have been started right before
+    state->dividend = SIO_DIV_UDIVIDEND;
+    state->divisor = SIO_DIV_UDIVISOR;
+    state->remainder = SIO_DIV_REMAINDER;
+    state->quotient = SIO_DIV_QUOTIENT;
+    return true;
+}
+
+// Writing the operands starts a division, writing the results afterwards overrides it
+static inline void dividerRestore(const dividerState *state)
+{
+    SIO_DIV_UDIVIDEND = state->dividend;
+    SIO_DIV_UDIVISOR = state->divisor;
+    SIO_DIV_REMAINDER = state->remainder;
+    SIO_DIV_QUOTIENT = state->quotient;
+}
+
+// One unsigned division, the caller has saved the divider
+static inline uint32_t dividerUnsigned(uint32_t n, uint32_t d, uint32_t *rem)
+{
+    SIO_DIV_UDIVIDEND = n;
+    SIO_DIV_UDIVISOR = d;
+    dividerWait();
+    *rem = SIO_DIV_REMAINDER;
+    return SIO_DIV_QUOTIENT;
+}
+
+// Quotient in the low and remainder in the high word, inlined into every entry point to save a call
+static inline uint64_t dividerUnsignedSaved(uint32_t n, uint32_t d)
+{
+    if (!d)
+        return (uint64_t)n << 32 | (uint32_t)__aeabi_idiv0(n ? -1 : 0);
+
+    dividerState state;
+    bool saved = dividerSave(&state);
+    uint32_t rem;
+    uint32_t quot = dividerUnsigned(n, d, &rem);
+    if (saved)
+        dividerRestore(&state);
+    return (uint64_t)rem << 32 | quot;
+}
+
+static inline uint64_t dividerSignedSaved(int32_t n, int32_t d)
+{
+    if (!d)
+        return (uint64_t)(uint32_t)n << 32 | (uint32_t)__aeabi_idiv0(n > 0 ? INT32_MAX : n < 0 ? INT32_MIN : 0);
+
+    dividerState state;
+    bool saved = dividerSave(&state);
+    SIO_DIV_SDIVIDEND = n;
+    SIO_DIV_SDIVISOR = d;
+    dividerWait();
+    uint32_t rem = SIO_DIV_REMAINDER;
+    uint32_t quot = SIO_DIV_QUOTIENT;
+    if (saved)
+        dividerRestore(&state);
+    return (uint64_t)rem << 32 | quot;
+}
+
+// The run-time ABI names cannot be defined in C under their own prototypes, so the functions get those as assembler
+// labels. The divmod variants return the quotient in r0 and the remainder in r1, the halves of a 64-bit result.
+uint64_t dividerUidivmod(uint32_t n, uint32_t d) __asm__("__aeabi_uidivmod");
+TIME_CRITICAL uint64_t dividerUidivmod(uint32_t n, uint32_t d)
+{
+    return dividerUnsignedSaved(n, d);
+}
+
+uint32_t dividerUidiv(uint32_t n, uint32_t d) __asm__("__aeabi_uidiv");
+TIME_CRITICAL uint32_t dividerUidiv(uint32_t n, uint32_t d)
+{
+    return (uint32_t)dividerUnsignedSaved(n, d);
+}
+
+uint64_t dividerIdivmod(int32_t n, int32_t d) __asm__("__aeabi_idivmod");
+TIME_CRITICAL uint64_t dividerIdivmod(int32_t n, int32_t d)
+{
+    return dividerSignedSaved(n, d);
+}
+
+int32_t dividerIdiv(int32_t n, int32_t d) __asm__("__aeabi_idiv");
+TIME_CRITICAL int32_t dividerIdiv(int32_t n, int32_t d)
+{
+    return (int32_t)dividerSignedSaved(n, d);
+}
+
+// libgcc also exports the 32-bit functions under their generic names from the same objects, taking those over as
+// well keeps a call to them from pulling in a second definition
+uint32_t dividerUdivsi3(uint32_t n, uint32_t d) __asm__("__udivsi3") __attribute__((alias("__aeabi_uidiv")));
+int32_t dividerDivsi3(int32_t n, int32_t d) __asm__("__divsi3") __attribute__((alias("__aeabi_idiv")));
+
+// Quotient of n / d with the remainder in *rem. Operands of up to 32 bits take one division, divisors of up to
+// 16 bits three and anything wider goes to libgcc.
+__attribute__((used)) TIME_CRITICAL static uint64_t dividerUldivmod(uint64_t n, uint64_t d, uint64_t *rem)
+{
+    if (!d)
+    {
+        *rem = n;
+        return __aeabi_ldiv0(n ? -1 : 0);
+    }
+    if (!(n >> 32) && !(d >> 32))
+    {
+        uint64_t result = dividerUnsignedSaved(n, d);
+        *rem = result >> 32;
+        return (uint32_t)result;
+    }
+    if (d >> 16)
+        return __udivmoddi4(n, d, rem);
+
+    // The remainder of each step is below d, so shifted up by 16 bits together with the next 16 bits of n it
+    // still fits the divider
+    dividerState state;
+    bool saved = dividerSave(&state);
+    uint32_t r;
+    uint32_t high = dividerUnsigned(n >> 32, d, &r);
+    uint32_t mid = dividerUnsigned(r << 16 | ((uint32_t)(n >> 16) & 0xffff), d, &r);
+    uint32_t low = dividerUnsigned(r << 16 | ((uint32_t)n & 0xffff), d, &r);
+    if (saved)
+        dividerRestore(&state);
+    *rem = r;
+    return (uint64_t)high << 32 | mid << 16 | low;
+}
+
+__attribute__((used)) TIME_CRITICAL static int64_t dividerLdivmod(int64_t n, int64_t d, int64_t *rem)
+{
+    if (!d)
+    {
+        *rem = n;
+        return __aeabi_ldiv0(n > 0 ? INT64_MAX : n < 0 ? INT64_MIN : 0);
+    }
+    // The quotient is negative when the signs differ, the remainder takes the sign of the dividend
+    uint64_t urem;
+    uint64_t quot = dividerUldivmod(n < 0 ? -(uint64_t)n : (uint64_t)n, d < 0 ? -(uint64_t)d : (uint64_t)d, &urem);
+    *rem = n < 0 ? -urem : urem;
+    return (n < 0) != (d < 0) ? -quot : quot;
+}
+
+// The 64-bit divmod variants return the quotient in r0:r1 and the remainder in r2:r3, which C cannot express.
+// The remainder is passed out through the stack, as the pointer argument that follows the two 64-bit ones.
+#define DIVIDER_DIVMOD64(name, helper)                                                                              \
+    __attribute__((naked)) TIME_CRITICAL void name(void)                                                            \
+    {                                                                                                               \
+        asm volatile (                                                                                              \
+            "   push {r4, lr}               \n"                                                                     \
+            "   sub sp, #16                 \n"                                                                     \
+            "   add r4, sp, #8              \n"                                                                     \
+            "   str r4, [sp]                \n" /* rem */                                                           \
+            "   bl " #helper "              \n"                                                                     \
+            "   ldr r2, [sp, #8]            \n"                                                                     \
+            "   ldr r3, [sp, #12]           \n"                                                                     \
+            "   add sp, #16                 \n"                                                                     \
+            "   pop {r4, pc}                \n");                                                                   \
+    }
+
+void dividerUldivmodAbi(void) __asm__("__aeabi_uldivmod");
+DIVIDER_DIVMOD64(dividerUldivmodAbi, dividerUldivmod)
+void dividerLdivmodAbi(void) __asm__("__aeabi_ldivmod");
+DIVIDER_DIVMOD64(dividerLdivmodAbi, dividerLdivmod)
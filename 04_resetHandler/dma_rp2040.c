@@ -0,0 +1,266 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "dma_rp2040.h"
+#include "irq_rp2040.h"
+#include "multicore_rp2040.h"
+#include "regs_rp2040.h"
+#include "sections.h"
+#include "spinlock_rp2040.h"
+
+// Define necessary register addresses
+// DMA, peripherals have atomic set and clear aliases at +0x2000 and +0x3000
+#define DMA_BASE                    (0x50000000)
+#define DMA_READ_ADDR(ch)           (*(volatile uint32_t *) (DMA_BASE + 0x040 * (ch) + 0x000))
+#define DMA_WRITE_ADDR(ch)          (*(volatile uint32_t *) (DMA_BASE + 0x040 * (ch) + 0x004))
+#define DMA_TRANS_COUNT(ch)         (*(volatile uint32_t *) (DMA_BASE + 0x040 * (ch) + 0x008))
+#define DMA_CTRL_TRIG(ch)           (*(volatile uint32_t *) (DMA_BASE + 0x040 * (ch) + 0x00c))
+#define DMA_AL1_CTRL(ch)            (*(volatile uint32_t *) (DMA_BASE + 0x040 * (ch) + 0x010))
+#define DMA_INTS(irq)               (*(volatile uint32_t *) (DMA_BASE + 0x40c + 0x010 * (irq)))
+#define DMA_INTE_SET(irq)           (*(volatile uint32_t *) (DMA_BASE + 0x2000 + 0x404 + 0x010 * (irq)))
+#define DMA_INTE_CLR(irq)           (*(volatile uint32_t *) (DMA_BASE + 0x3000 + 0x404 + 0x010 * (irq)))
+#define DMA_SNIFF_CTRL              (*(volatile uint32_t *) (DMA_BASE + 0x434))
+#define DMA_SNIFF_DATA              (*(volatile uint32_t *) (DMA_BASE + 0x438))
+#define DMA_CHAN_ABORT              (*(volatile uint32_t *) (DMA_BASE + 0x444))
+// RESETS
+#define RESETS_RESET                (*(volatile uint32_t *) (0x4000c000))
+#define RESETS_RESET_DONE           (*(volatile uint32_t *) (0x4000c008))
+
+#define DMA_CTRL_EN                 (1 << 0)
+#define DMA_CTRL_RING_SIZE(log2)    ((log2) << 6)
+#define DMA_CTRL_RING_SEL_WRITE     (1 << 10)
+#define DMA_CTRL_CHAIN_TO(ch)       ((ch) << 11)    // Chaining to itself is how a channel does not chain
+#define DMA_CTRL_IRQ_QUIET          (1 << 21)       // No interrupt at the end of the transfer, only on a null trigger
+#define DMA_CTRL_BUSY               (1 << 24)
+
+#define DMA_SNIFF_CTRL_EN           (1 << 0)
+#define DMA_SNIFF_CTRL_DMACH(ch)    ((ch) << 1)
+#define DMA_SNIFF_CTRL_CALC(calc)   ((calc) << 5)
+#define DMA_SNIFF_CTRL_BSWAP        (1 << 9)
+
+static uint32_t claimed;
+static dmaCallback callbacks[DMA_CHANNELS];
+static void *args[DMA_CHANNELS];
+static volatile bool releaseOnDone[DMA_CHANNELS];  // Channels of dmaMemcpy and dmaMemset
+static uint32_t fills[DMA_CHANNELS];                // Source word of dmaMemset
+static bool sniffClaimed;
+
+// Runs ahead of the constructors without a priority, which may already start transfers
+__attribute__((constructor(101))) static void dmaInit(void)
+{
+    SIO_SPINLOCK(SPINLOCK_DMA_CLAIM) = 0; // The SIO is not reset with the cores, a warm reset may leave it taken
+    regClear(&RESETS_RESET, 1 << 2); // Bring DMA out of reset state
+    while (!(RESETS_RESET_DONE & (1 << 2))); // Wait for DMA to respond
+}
+
+int32_t dmaClaim(void)
+{
+    int32_t channel = -1;
+    uint32_t primask = spinLock(SPINLOCK_DMA_CLAIM);
+    for (uint32_t i = 0; i < DMA_CHANNELS; ++i)
+    {
+        if (!(claimed & (1 << i)))
+        {
+            claimed |= 1 << i;
+            channel = i;
+            break;
+        }
+    }
+    spinUnlock(SPINLOCK_DMA_CLAIM, primask);
+    return channel;
+}
+
+void dmaRelease(uint32_t channel)
+{
+    dmaAbort(channel);
+    uint32_t primask = spinLock(SPINLOCK_DMA_CLAIM);
+    claimed &= ~(1 << channel);
+    spinUnlock(SPINLOCK_DMA_CLAIM, primask);
+}
+
+// Route the completion of a channel to the DMA interrupt of the calling core, DMA_IRQ_0 and DMA_IRQ_1 are adjacent
+static void dmaSetCallback(uint32_t channel, dmaCallback callback, void *arg)
+{
+    uint32_t core = coreNum();
+    callbacks[channel] = callback;
+    args[channel] = arg;
+    DMA_INTE_CLR(core ^ 1) = 1 << channel;
+    if (callback)
+    {
+        DMA_INTE_SET(core) = 1 << channel;
+        irqEnable(DMA_IRQ_0 + core);
+    }
+    else
+    {
+        DMA_INTE_CLR(core) = 1 << channel;
+    }
+}
+
+void dmaStart(uint32_t channel, const volatile void *read, volatile void *write, uint32_t count, uint32_t ctrl,
+              dmaCallback callback, void *arg)
+{
+    dmaSetCallback(channel, callback, arg);
+    DMA_READ_ADDR(channel) = (uint32_t)read;
+    DMA_WRITE_ADDR(channel) = (uint32_t)write;
+    DMA_TRANS_COUNT(channel) = count;
+    DMA_CTRL_TRIG(channel) = ctrl | DMA_CTRL_CHAIN_TO(channel) | DMA_CTRL_EN; // Writing CTRL_TRIG starts the transfer
+}
+
+bool dmaBusy(uint32_t channel)
+{
+    return DMA_CTRL_TRIG(channel) & DMA_CTRL_BUSY;
+}
+
+void dmaWait(uint32_t channel)
+{
+    while (dmaBusy(channel));
+}
+
+void dmaAbort(uint32_t channel)
+{
+    DMA_INTE_CLR(0) = 1 << channel; // An abort may still raise the completion interrupt, erratum RP2040-E13
+    DMA_INTE_CLR(1) = 1 << channel;
+    DMA_CHAN_ABORT = 1 << channel;
+    while (DMA_CHAN_ABORT & (1 << channel)); // Reads 1 until the transfers in flight are done
+    DMA_INTS(0) = 1 << channel;
+    DMA_INTS(1) = 1 << channel;
+    callbacks[channel] = 0;
+}
+
+void dmaBlockSet(dmaBlock *block, const volatile void *read, volatile void *write, uint32_t count, uint32_t ctrl)
+{
+    block->ctrl = ctrl;
+    block->read = (uint32_t)read;
+    block->write = (uint32_t)write;
+    block->count = count;
+}
+
+void dmaScatterGather(uint32_t dataChannel, uint32_t ctrlChannel, dmaBlock *blocks, uint32_t count,
+                      dmaCallback callback, void *arg)
+{
+    // Every block chains back to ctrlChannel for the next one. They are quiet, only the null trigger of the
+    // terminator, a block with a count of 0, raises the interrupt.
+    uint32_t chain = DMA_CTRL_IRQ_QUIET | DMA_CTRL_EN;
+    for (uint32_t i = 0; i < count; ++i)
+        blocks[i].ctrl = (blocks[i].ctrl & ~DMA_CTRL_CHAIN_TO(0xf)) | chain | DMA_CTRL_CHAIN_TO(ctrlChannel);
+    dmaBlockSet(&blocks[count], 0, 0, 0, chain | DMA_CTRL_CHAIN_TO(dataChannel));
+    dmaSetCallback(dataChannel, callback, arg);
+
+    // ctrlChannel writes a block at a time into the alias ending in TRANS_COUNT_TRIG, wrapping around those 16 bytes
+    dmaStart(ctrlChannel, blocks, &DMA_AL1_CTRL(dataChannel), 4,
+             DMA_SIZE_WORD | DMA_INCR_READ | DMA_INCR_WRITE | DMA_CTRL_RING_SIZE(4) | DMA_CTRL_RING_SEL_WRITE | DMA_TREQ(DREQ_PERMANENT), 0, 0);
+}
+
+// Without a callback of the caller the interrupt is still needed to release the channel
+static void memDone(uint32_t channel, void *arg)
+{
+    (void)channel;
+    (void)arg;
+}
+
+int32_t dmaMemcpy(void *dst, const void *src, uint32_t len, dmaCallback callback, void *arg)
+{
+    int32_t channel = (len >= DMA_MIN_BYTES) ? dmaClaim() : -1;
+    if (channel < 0)
+    {
+        memcpy(dst, src, len);
+        if (callback)
+            callback((uint32_t)-1, arg);
+        return -1;
+    }
+
+    uint8_t *d = dst;
+    const uint8_t *s = src;
+    releaseOnDone[channel] = true;
+    if (((uint32_t)d ^ (uint32_t)s) & 3)
+    {
+        // Misaligned against each other, byte transfers still take the work off the CPU
+        dmaStart(channel, s, d, len, DMA_SIZE_BYTE | DMA_INCR_READ | DMA_INCR_WRITE | DMA_TREQ(DREQ_PERMANENT), callback ? callback : memDone, arg);
+        return channel;
+    }
+    uint32_t head = -(uint32_t)d & 3;
+    uint32_t words = (len - head) / 4;
+    uint32_t tail = len - head - 4 * words;
+    memcpy(d, s, head);
+    memcpy(d + head + 4 * words, s + head + 4 * words, tail);
+    dmaStart(channel, s + head, d + head, words, DMA_SIZE_WORD | DMA_INCR_READ | DMA_INCR_WRITE | DMA_TREQ(DREQ_PERMANENT),
+             callback ? callback : memDone, arg);
+    return channel;
+}
+
+int32_t dmaMemset(void *dst, uint8_t value, uint32_t len, dmaCallback callback, void *arg)
+{
+    int32_t channel = (len >= DMA_MIN_BYTES) ? dmaClaim() : -1;
+    if (channel < 0)
+    {
+        memset(dst, value, len);
+        if (callback)
+            callback((uint32_t)-1, arg);
+        return -1;
+    }
+
+    // A single word read over and over without incrementing
+    uint8_t *d = dst;
+    uint32_t head = -(uint32_t)d & 3;
+    uint32_t words = (len - head) / 4;
+    uint32_t tail = len - head - 4 * words;
+    memset(d, value, head);
+    memset(d + head + 4 * words, value, tail);
+    fills[channel] = value * 0x01010101;
+    releaseOnDone[channel] = true;
+    dmaStart(channel, &fills[channel], d + head, words, DMA_SIZE_WORD | DMA_INCR_WRITE | DMA_TREQ(DREQ_PERMANENT),
+             callback ? callback : memDone, arg);
+    return channel;
+}
+
+bool dmaSniffClaim(void)
+{
+    uint32_t primask = spinLock(SPINLOCK_DMA_CLAIM);
+    bool free = !sniffClaimed;
+    sniffClaimed = true;
+    spinUnlock(SPINLOCK_DMA_CLAIM, primask);
+    return free;
+}
+
+void dmaSniffRelease(void)
+{
+    DMA_SNIFF_CTRL = 0;
+    uint32_t primask = spinLock(SPINLOCK_DMA_CLAIM);
+    sniffClaimed = false;
+    spinUnlock(SPINLOCK_DMA_CLAIM, primask);
+}
+
+void dmaSniffStart(uint32_t channel, uint32_t calc, bool bswap, uint32_t seed)
+{
+    DMA_SNIFF_CTRL = 0;
+    DMA_SNIFF_DATA = seed;
+    DMA_SNIFF_CTRL = DMA_SNIFF_CTRL_EN | DMA_SNIFF_CTRL_DMACH(channel) | DMA_SNIFF_CTRL_CALC(calc) | (bswap ? DMA_SNIFF_CTRL_BSWAP : 0);
+}
+
+uint32_t dmaSniffResult(void)
+{
+    return DMA_SNIFF_DATA;
+}
+
+// Every channel with a callback completes through the interrupt of its core, a callback may start the next transfer right away
+static void dmaComplete(uint32_t irq)
+{
+    uint32_t status = DMA_INTS(irq);
+    DMA_INTS(irq) = status; // Write 1 to clear
+    for (uint32_t channel = 0; status; ++channel, status >>= 1)
+    {
+        if (!(status & 1))
+            continue;
+        if (callbacks[channel])
+            callbacks[channel](channel, args[channel]);
+        if (releaseOnDone[channel])
+        {
+            releaseOnDone[channel] = false;
+            dmaRelease(channel);
+        }
+    }
+}
+
+TIME_CRITICAL void dmaIrq0(void) { dmaComplete(0); }
+TIME_CRITICAL void dmaIrq1(void) { dmaComplete(1); }
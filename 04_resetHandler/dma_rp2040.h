@@ -0,0 +1,99 @@
+#ifndef DMA_RP2040_H
+#define DMA_RP2040_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DMA_CHANNELS                (12)
+
+// Transfer options for dmaStart, fields of CH_CTRL_TRIG
+#define DMA_HIGH_PRIORITY           (1 << 1)
+#define DMA_SIZE_BYTE               (0 << 2)
+#define DMA_SIZE_HALFWORD           (1 << 2)
+#define DMA_SIZE_WORD               (2 << 2)
+#define DMA_INCR_READ               (1 << 4)
+#define DMA_INCR_WRITE              (1 << 5)
+#define DMA_TREQ(dreq)              ((dreq) << 15)
+#define DMA_BSWAP                   (1 << 22)
+#define DMA_SNIFF                   (1 << 23)
+
+// Below this many bytes dmaMemcpy and dmaMemset run on the CPU, setting up a channel and taking its interrupt
+// costs more than the copy. 256 is an estimate, to be tuned with make benchTarget BENCH=dmaCopy.
+#ifndef DMA_MIN_BYTES
+#define DMA_MIN_BYTES               (256)
+#endif
+
+// Transfer request sources for DMA_TREQ
+#define DREQ_XIP_STREAM             (37)
+#define DREQ_PERMANENT              (0x3f)      // Unpaced, as fast as the bus allows
+
+// Checksums of the sniffer for dmaSniffStart, the CRCs take the data most significant bit first
+#define DMA_SNIFF_CRC32             (0x0)       // Polynomial 0x04c11db7, CRC-32/MPEG-2 with a seed of 0xffffffff
+#define DMA_SNIFF_CRC32_REV         (0x1)       // Same with bit-reversed data
+#define DMA_SNIFF_CRC16             (0x2)       // CRC-16-CCITT
+#define DMA_SNIFF_CRC16_REV         (0x3)
+#define DMA_SNIFF_XOR               (0xe)
+#define DMA_SNIFF_SUM               (0xf)
+
+// Called in the DMA interrupt of the core that started the transfer once it completed,
+// DMA_IRQ_0 for core0 and DMA_IRQ_1 for core1
+typedef void (*dmaCallback)(uint32_t channel, void *arg);
+
+// Control block of a scatter-gather list, laid out like the CTRL, READ_ADDR, WRITE_ADDR and TRANS_COUNT_TRIG alias
+typedef struct
+{
+    uint32_t ctrl;
+    uint32_t read;
+    uint32_t write;
+    uint32_t count;
+} dmaBlock;
+
+// Take a free channel, returns -1 if all are in use. Safe from both cores.
+int32_t dmaClaim(void);
+void dmaRelease(uint32_t channel);
+
+// Transfer count items of the size in ctrl from read to write. The channel does not chain. With a callback
+// the channel raises the DMA interrupt of the calling core on completion, without one it stays quiet.
+void dmaStart(uint32_t channel, const volatile void *read, volatile void *write, uint32_t count, uint32_t ctrl,
+              dmaCallback callback, void *arg);
+
+bool dmaBusy(uint32_t channel);
+void dmaWait(uint32_t channel);
+
+// Stop a transfer, its callback is not called
+void dmaAbort(uint32_t channel);
+
+// Fill in a scatter-gather block, ctrl takes the same options as dmaStart
+void dmaBlockSet(dmaBlock *block, const volatile void *read, volatile void *write, uint32_t count, uint32_t ctrl);
+
+// Run the count blocks one after the other on dataChannel. ctrlChannel loads every block into dataChannel, which
+// chains back to it when done. blocks must hold count + 1 entries, the last one is made the terminator here.
+// The callback runs once after the last block, on dataChannel.
+void dmaScatterGather(uint32_t dataChannel, uint32_t ctrlChannel, dmaBlock *blocks, uint32_t count,
+                      dmaCallback callback, void *arg);
+
+// memcpy and memset on a channel of their own, which is released again on completion. The bytes up to the next word
+// boundary at either end are done on the CPU right away. The buffers must be left alone until the callback.
+// Returns the channel, or -1 if the CPU did all of it as the size is below DMA_MIN_BYTES or no channel was free,
+// the callback has then been called already with channel -1.
+int32_t dmaMemcpy(void *dst, const void *src, uint32_t len, dmaCallback callback, void *arg);
+int32_t dmaMemset(void *dst, uint8_t value, uint32_t len, dmaCallback callback, void *arg);
+
+// There is a single sniffer, taken like a channel. Returns false while it is in use. Safe from both cores.
+bool dmaSniffClaim(void);
+void dmaSniffRelease(void);
+
+// Seed the sniffer and attach it to channel, it then folds in every item the channel reads with DMA_SNIFF in its ctrl.
+// The data is byte reversed first when bswap is set, which puts a little-endian word into memory order for a CRC.
+void dmaSniffStart(uint32_t channel, uint32_t calc, bool bswap, uint32_t seed);
+uint32_t dmaSniffResult(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,6 +1,10 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "profile_rp2040.h"
+#include "regs_rp2040.h"
+#include "sched_rp2040.h"
+
 // Define necessary register addresses
 #define RESETS_RESET                                    *(volatile uint32_t *) (0x4000c000)
 #define RESETS_RESET_DONE                               *(volatile uint32_t *) (0x4000c008)
@@ -8,23 +12,47 @@
 #define SIO_GPIO_OE_SET                                 *(volatile uint32_t *) (0xd0000024)
 #define SIO_GPIO_OUT_XOR                                *(volatile uint32_t *) (0xd000001c)
 
-// Declare usSleep function
-extern void usSleep(uint64_t us);
+#ifdef STARTUP_CYCLES
+// Declare startupCyclesStop function
+extern void startupCyclesStop(void);
+#endif
 
 // Global variable counting how many times LED switched state
 uint8_t blinkCnt;
 
+THREAD_STACK(blinkStack, 256);
+static thread blinkThread;
+
+// Blink control loop, ends after 20 state changes
+static void blink(void *arg)
+{
+    (void)arg;
+    while (++blinkCnt < 21)
+    {
+        threadSleep(500000); // Wait for 0.5sec, other threads run meanwhile
+        SIO_GPIO_OUT_XOR = 1 << 25; // Flip output for GPIO 25
+    }
+}
+
 // Main entry point
 int main(void)
 {
-    RESETS_RESET &= ~(1 << 5); // Bring IO_BANK0 out of reset state
+#ifdef STARTUP_CYCLES
+    startupCyclesStop(); // Capture the cycles spent getting here
+#endif
+
+#ifdef PROFILE_US
+    profileStart(PROFILE_US); // Sample where the time goes, decoded by make profReport
+#endif
+
+    regClear(&RESETS_RESET, 1 << 5); // Bring IO_BANK0 out of reset state
     while (!(RESETS_RESET_DONE & (1 << 5))); // Wait for peripheral to respond
     IO_BANK0_GPIO25_CTRL = 5; // Set GPIO 25 function to SIO
-    SIO_GPIO_OE_SET |= 1 << 25; // Set output enable for GPIO 25 in SIO
+    SIO_GPIO_OE_SET = 1 << 25; // Set output enable for GPIO 25 in SIO
 
-    while (++blinkCnt < 21)
-    {
-        usSleep(500000); // Wait for 0.5sec
-        SIO_GPIO_OUT_XOR |= 1 << 25;  // Flip output for GPIO 25
-    }
+    threadCreate(&blinkThread, blink, 0, blinkStack, 256, 1);
+    schedStart(); // main carries on as the idle thread
+
+    while (true)
+        asm volatile ("wfi"); // Sleep until an interrupt makes a thread ready
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sections.h"
+
+// Define necessary register addresses
+// SSI
+#define SSI_BASE                    (0x18000000)
+#define SSI_CTRLR0                  (*(volatile uint32_t *) (SSI_BASE + 0x000))
+#define SSI_SSIENR                  (*(volatile uint32_t *) (SSI_BASE + 0x008))
+#define SSI_BAUDR                   (*(volatile uint32_t *) (SSI_BASE + 0x014))
+#define SSI_SR                      (*(volatile uint32_t *) (SSI_BASE + 0x028))
+#define SSI_RX_SAMPLE_DLY           (*(volatile uint32_t *) (SSI_BASE + 0x0f0))
+#define SSI_SPI_CTRLR0              (*(volatile uint32_t *) (SSI_BASE + 0x0f4))
+
+// Supported flash parts
+#define FLASH_PART_W25Q80DV         (0)
+#define FLASH_PART_W25Q16JV         (1)
+
+// Flash part on the board, can be overridden from the Makefile with -DFLASH_PART=...
+#ifndef FLASH_PART
+#define FLASH_PART                  FLASH_PART_W25Q80DV
+#endif
+
+// Extra delay on the data path from the flash back to the SSI, i.e. QSPI pads and board traces
+#define FLASH_PAD_DELAY_NS          (4)
+
+// Timing limits of a flash part, taken from the AC electrical characteristics in its datasheet
+typedef struct
+{
+    uint32_t readMaxHz;     // Max SCK frequency for Read Data (03h)
+    uint32_t fastReadMaxHz; // Max SCK frequency for Fast Read (0Bh), Fast Read Quad Output (6Bh) and Fast Read Quad I/O (EBh)
+    uint32_t clkToOutNs;    // Clock low to output valid, tCLQV
+} flashTiming;
+
+static const flashTiming flashParts[] =
+{
+    [FLASH_PART_W25Q80DV] = {50000000, 104000000, 7},
+    [FLASH_PART_W25Q16JV] = {50000000, 133000000, 6},
+};
+
+// Reprogram the SSI clock while executing from SRAM. XIP is unusable while the SSI is disabled,
+// so this function, and everything it touches, must not live in flash.
+TIME_CRITICAL static void flashTimingApply(uint32_t baud, uint32_t rxDly)
+{
+    uint32_t primask;
+    asm volatile ("mrs %0, primask" : "=r"(primask)); // Save interrupt state
+    asm volatile ("cpsid i"); // Vector table and handlers are in flash, so no interrupts until XIP is back
+
+    while (SSI_SR & (1 << 0)); // Wait here while SSI is busy with a XIP transfer
+    SSI_SSIENR = 0; // Disable SSI to configure it, all other XIP settings made by boot2 are retained
+    SSI_BAUDR = baud; // Set new clock divider
+    SSI_RX_SAMPLE_DLY = rxDly; // Set new RX sample delay in clk_sys cycles
+    SSI_SSIENR = 1; // Enable SSI, XIP is available again from here
+
+    asm volatile ("msr primask, %0" :: "r"(primask)); // Restore interrupt state
+}
+
+void flashTimingSetup(uint32_t clkSys)
+{
+    const flashTiming *part = &flashParts[FLASH_PART];
+
+    // Read Data (03h) in standard SPI frame format is the only command with a lower frequency limit
+    bool readData = !(SSI_CTRLR0 & (3 << 21)) && ((SSI_SPI_CTRLR0 >> 24) == 0x03);
+    uint32_t sckMax = readData ? part->readMaxHz : part->fastReadMaxHz;
+
+    // Lowest even divider that keeps SCK within the flash limits, SSI doesn't support odd dividers
+    uint32_t baud = (clkSys + sckMax - 1) / sckMax;
+    baud = (baud + 1) & ~1u;
+    if (baud < 2)
+        baud = 2;
+
+    // Data is shifted out on the falling edge of SCK and sampled baud / 2 cycles later on the rising edge.
+    // Delay the sampling point by the number of clk_sys cycles the data is late on the bus.
+    uint32_t validCycles = ((part->clkToOutNs + FLASH_PAD_DELAY_NS) * (clkSys / 1000000) + 999) / 1000;
+    uint32_t rxDly = (validCycles > baud / 2) ? (validCycles - baud / 2) : 0;
+
+    flashTimingApply(baud, rxDly);
+}
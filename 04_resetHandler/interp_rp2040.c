@@ -0,0 +1,153 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "interp_rp2040.h"
+
+// Define necessary register addresses
+#ifdef HOST_MODEL
+#include "interpModel.h" // Registers are routed to the host-side model
+#else
+#include "sections.h"
+// SIO interpolators, INTERP0 and INTERP1 of the calling core
+#define INTERP_BASE(n)              (0xd0000080 + 0x040 * (n))
+#define INTERP_ACCUM0(n)            (*(volatile uint32_t *) (INTERP_BASE(n) + 0x000))
+#define INTERP_ACCUM1(n)            (*(volatile uint32_t *) (INTERP_BASE(n) + 0x004))
+#define INTERP_BASE0(n)             (*(volatile uint32_t *) (INTERP_BASE(n) + 0x008))
+#define INTERP_BASE1(n)             (*(volatile uint32_t *) (INTERP_BASE(n) + 0x00c))
+#define INTERP_BASE2(n)             (*(volatile uint32_t *) (INTERP_BASE(n) + 0x010))
+#define INTERP_POP_FULL(n)          (*(volatile uint32_t *) (INTERP_BASE(n) + 0x01c))
+#define INTERP_PEEK_LANE0(n)        (*(volatile uint32_t *) (INTERP_BASE(n) + 0x020))
+#define INTERP_PEEK_LANE1(n)        (*(volatile uint32_t *) (INTERP_BASE(n) + 0x024))
+#define INTERP_CTRL_LANE0(n)        (*(volatile uint32_t *) (INTERP_BASE(n) + 0x02c))
+#define INTERP_CTRL_LANE1(n)        (*(volatile uint32_t *) (INTERP_BASE(n) + 0x030))
+#define INTERP_ACCUM1_ADD(n)        (*(volatile uint32_t *) (INTERP_BASE(n) + 0x038))
+#define INTERP_BASE_1AND0(n)        (*(volatile uint32_t *) (INTERP_BASE(n) + 0x03c))
+#endif
+
+// Fields of CTRL_LANE0 and CTRL_LANE1. A lane takes its accumulator, shifts it right, masks bits lsb - msb,
+// optionally sign extends from msb and adds its base. The full result is both masked values plus BASE2.
+#define INTERP_CTRL_SHIFT(n)        ((n) << 0)
+#define INTERP_CTRL_MASK_LSB(n)     ((n) << 5)
+#define INTERP_CTRL_MASK_MSB(n)     ((n) << 10)
+#define INTERP_CTRL_SIGNED          (1 << 15)
+#define INTERP_CTRL_ADD_RAW         (1 << 18)   // The lane result adds the base to the raw accumulator
+#define INTERP_CTRL_BLEND           (1 << 21)   // Lane 0 of INTERP0 only, lane 1 blends from BASE0 to BASE1
+#define INTERP_CTRL_CLAMP           (1 << 22)   // Lane 0 of INTERP1 only, clamps to BASE0 - BASE1
+
+void interpSave(uint32_t interp, interpState *state)
+{
+    state->accum[0] = INTERP_ACCUM0(interp);
+    state->accum[1] = INTERP_ACCUM1(interp);
+    state->base[0] = INTERP_BASE0(interp);
+    state->base[1] = INTERP_BASE1(interp);
+    state->base[2] = INTERP_BASE2(interp);
+    state->ctrl[0] = INTERP_CTRL_LANE0(interp);
+    state->ctrl[1] = INTERP_CTRL_LANE1(interp);
+}
+
+void interpRestore(uint32_t interp, const interpState *state)
+{
+    INTERP_CTRL_LANE0(interp) = state->ctrl[0];
+    INTERP_CTRL_LANE1(interp) = state->ctrl[1];
+    INTERP_ACCUM0(interp) = state->accum[0];
+    INTERP_ACCUM1(interp) = state->accum[1];
+    INTERP_BASE0(interp) = state->base[0];
+    INTERP_BASE1(interp) = state->base[1];
+    INTERP_BASE2(interp) = state->base[2];
+}
+
+// Lane 0 turns the phase into a byte offset into the table, the full result adds the table address and popping it
+// writes back phase + step. Lane 1 stays at 0.
+TIME_CRITICAL uint32_t interpTableLookup(int16_t *dst, const int16_t *table, uint32_t tableBits, uint32_t phase,
+                                         uint32_t step, uint32_t count)
+{
+    INTERP_CTRL_LANE0(0) = INTERP_CTRL_SHIFT(31 - tableBits) | INTERP_CTRL_MASK_LSB(1) | INTERP_CTRL_MASK_MSB(tableBits) | INTERP_CTRL_ADD_RAW;
+    INTERP_CTRL_LANE1(0) = INTERP_CTRL_MASK_LSB(0) | INTERP_CTRL_MASK_MSB(0);
+    INTERP_ACCUM0(0) = phase;
+    INTERP_BASE0(0) = step;
+    INTERP_ACCUM1(0) = 0;
+    INTERP_BASE1(0) = 0;
+    INTERP_BASE2(0) = (uintptr_t)table;
+    for (uint32_t i = 0; i < count; ++i)
+        dst[i] = *(const int16_t *)INTERP_POP_FULL(0);
+    return INTERP_ACCUM0(0);
+}
+
+TIME_CRITICAL uint32_t interpTableLookupC(int16_t *dst, const int16_t *table, uint32_t tableBits, uint32_t phase,
+                                          uint32_t step, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i, phase += step)
+        dst[i] = table[phase >> (32 - tableBits)];
+    return phase;
+}
+
+// Lane 1 takes bits 15:8 of alpha as the fraction, BASE_1AND0 loads both samples in one store, sign extended as both
+// lanes are signed
+TIME_CRITICAL uint32_t interpBlend(int16_t *dst, const int16_t *a, const int16_t *b, uint32_t alpha, uint32_t step,
+                                   uint32_t count)
+{
+    INTERP_CTRL_LANE0(0) = INTERP_CTRL_MASK_MSB(31) | INTERP_CTRL_SIGNED | INTERP_CTRL_BLEND;
+    INTERP_CTRL_LANE1(0) = INTERP_CTRL_SHIFT(8) | INTERP_CTRL_MASK_LSB(0) | INTERP_CTRL_MASK_MSB(7) | INTERP_CTRL_SIGNED;
+    INTERP_ACCUM1(0) = alpha;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        INTERP_BASE_1AND0(0) = (uint16_t)a[i] | (uint32_t)b[i] << 16;
+        dst[i] = INTERP_PEEK_LANE1(0);
+        INTERP_ACCUM1_ADD(0) = step;
+    }
+    return INTERP_ACCUM1(0);
+}
+
+TIME_CRITICAL uint32_t interpBlendC(int16_t *dst, const int16_t *a, const int16_t *b, uint32_t alpha, uint32_t step,
+                                    uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i, alpha += step)
+        dst[i] = a[i] + (((b[i] - a[i]) * (int32_t)((alpha >> 8) & 0xff)) >> 8);
+    return alpha;
+}
+
+// The signed mask of bits 0 - (31 - shift) makes the right shift arithmetic, the clamp of INTERP1 saturates
+TIME_CRITICAL void interpScale(int16_t *dst, const int16_t *src, int32_t gain, uint32_t shift, int32_t min, int32_t max,
+                               uint32_t count)
+{
+    INTERP_CTRL_LANE0(1) = INTERP_CTRL_SHIFT(shift) | INTERP_CTRL_MASK_LSB(0) | INTERP_CTRL_MASK_MSB(31 - shift) | INTERP_CTRL_SIGNED | INTERP_CTRL_CLAMP;
+    INTERP_BASE0(1) = min;
+    INTERP_BASE1(1) = max;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        INTERP_ACCUM0(1) = (uint32_t)src[i] * (uint32_t)gain;
+        dst[i] = INTERP_PEEK_LANE0(1);
+    }
+}
+
+TIME_CRITICAL void interpScaleC(int16_t *dst, const int16_t *src, int32_t gain, uint32_t shift, int32_t min, int32_t max,
+                                uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        int32_t value = (int32_t)((uint32_t)src[i] * (uint32_t)gain) >> shift;
+        dst[i] = value < min ? min : value > max ? max : value;
+    }
+}
+
+TIME_CRITICAL void interpExtract(uint32_t *dst, const uint32_t *src, uint32_t lsb, uint32_t width, bool isSigned,
+                                 uint32_t count)
+{
+    INTERP_CTRL_LANE0(0) = INTERP_CTRL_SHIFT(lsb) | INTERP_CTRL_MASK_LSB(0) | INTERP_CTRL_MASK_MSB(width - 1) | (isSigned ? INTERP_CTRL_SIGNED : 0);
+    INTERP_BASE0(0) = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        INTERP_ACCUM0(0) = src[i];
+        dst[i] = INTERP_PEEK_LANE0(0);
+    }
+}
+
+TIME_CRITICAL void interpExtractC(uint32_t *dst, const uint32_t *src, uint32_t lsb, uint32_t width, bool isSigned,
+                                  uint32_t count)
+{
+    // The field is moved to the top and back down, arithmetically if signed
+    uint32_t up = 32 - lsb - width;
+    uint32_t down = 32 - width;
+    for (uint32_t i = 0; i < count; ++i)
+        dst[i] = isSigned ? (uint32_t)((int32_t)(src[i] << up) >> down) : (src[i] << up) >> down;
+}
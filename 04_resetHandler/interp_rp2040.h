@@ -0,0 +1,56 @@
+#ifndef INTERP_RP2040_H
+#define INTERP_RP2040_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Array kernels on the SIO interpolators of the calling core, each core has its own INTERP0 and INTERP1. One element
+// costs a store of the operand and a load of the result in single cycle IO, the shift, mask, add, blend and clamp
+// come for free. Every kernel has a C version with the same results bit for bit, see make interpHost, for code
+// that must leave the interpolators alone, e.g. an interrupt handler.
+//
+// A kernel reconfigures both interpolators and leaves them that way. A handler that interrupts a kernel and uses
+// them itself has to bracket that with interpSave and interpRestore.
+
+// Everything a kernel changes, including the accumulators of a kernel in progress
+typedef struct
+{
+    uint32_t accum[2];
+    uint32_t base[3];
+    uint32_t ctrl[2];
+} interpState;
+
+void interpSave(uint32_t interp, interpState *state);
+void interpRestore(uint32_t interp, const interpState *state);
+
+// Wavetable lookup, dst[i] = table[phase >> (32 - tableBits)] with phase advancing by step per element. The table
+// has 1 << tableBits entries, 1 - 31. Returns the phase after the last element to continue from.
+uint32_t interpTableLookup(int16_t *dst, const int16_t *table, uint32_t tableBits, uint32_t phase, uint32_t step,
+                           uint32_t count);
+uint32_t interpTableLookupC(int16_t *dst, const int16_t *table, uint32_t tableBits, uint32_t phase, uint32_t step,
+                            uint32_t count);
+
+// Crossfade, dst[i] = a[i] + ((b[i] - a[i]) * ((alpha >> 8) & 0xff) >> 8) with alpha advancing by step per element,
+// so 0x0000 - 0xffff goes from a to almost b. Returns alpha after the last element.
+uint32_t interpBlend(int16_t *dst, const int16_t *a, const int16_t *b, uint32_t alpha, uint32_t step, uint32_t count);
+uint32_t interpBlendC(int16_t *dst, const int16_t *a, const int16_t *b, uint32_t alpha, uint32_t step, uint32_t count);
+
+// Gain with saturation, dst[i] = src[i] * gain >> shift clamped to min - max, which have to lie within int16_t.
+// The product wraps at 32 bits, shift is 0 - 31.
+void interpScale(int16_t *dst, const int16_t *src, int32_t gain, uint32_t shift, int32_t min, int32_t max, uint32_t count);
+void interpScaleC(int16_t *dst, const int16_t *src, int32_t gain, uint32_t shift, int32_t min, int32_t max, uint32_t count);
+
+// Bit field extraction, dst[i] = the width bits of src[i] from bit lsb on, sign extended if isSigned.
+// width is 1 - 32 and lsb + width at most 32.
+void interpExtract(uint32_t *dst, const uint32_t *src, uint32_t lsb, uint32_t width, bool isSigned, uint32_t count);
+void interpExtractC(uint32_t *dst, const uint32_t *src, uint32_t lsb, uint32_t width, bool isSigned, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
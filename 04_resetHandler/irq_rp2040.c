@@ -0,0 +1,58 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "irq_rp2040.h"
+
+// Define necessary register addresses
+// SCB
+#define M0PLUS_VTOR                 (*(volatile uint32_t *) (0xe000ed08))
+// NVIC
+#define NVIC_ISER                   (*(volatile uint32_t *) (0xe000e100))
+#define NVIC_ICER                   (*(volatile uint32_t *) (0xe000e180))
+#define NVIC_ICPR                   (*(volatile uint32_t *) (0xe000e280))
+#define NVIC_IPR(n)                 (*(volatile uint32_t *) (0xe000e400 + 4 * (n)))
+
+#define VECTOR_COUNT                (16 + IRQ_COUNT + 6)   // The flash table has 48 entries, the last 6 unused
+
+// Vector table of core0, .ram_vector is the first section in SRAM and thereby 256 byte aligned as VTOR requires
+irqHandler ramVector[VECTOR_COUNT] __attribute__((section(".ram_vector")));
+extern const irqHandler vector[VECTOR_COUNT];
+
+void irqInit(void)
+{
+    for (uint32_t i = 0; i < VECTOR_COUNT; ++i)
+        ramVector[i] = vector[i];
+    M0PLUS_VTOR = (uint32_t)ramVector;
+    asm volatile ("dsb" ::: "memory"); // Table and VTOR are in place before the next exception
+}
+
+irqHandler irqSetHandler(uint32_t irq, irqHandler handler)
+{
+    // Whichever table VTOR points at, so core1 patches its own copy
+    irqHandler *table = (irqHandler *)M0PLUS_VTOR;
+    uint32_t primask = irqSave();
+    irqHandler old = table[16 + irq];
+    table[16 + irq] = handler;
+    irqRestore(primask);
+    return old;
+}
+
+void irqSetPriority(uint32_t irq, uint32_t priority)
+{
+    // The priority registers only take word accesses, the 2 implemented bits are the top ones of each byte
+    uint32_t shift = 8 * (irq & 3) + 6;
+    uint32_t primask = irqSave();
+    NVIC_IPR(irq >> 2) = (NVIC_IPR(irq >> 2) & ~(3 << shift)) | ((priority & 3) << shift);
+    irqRestore(primask);
+}
+
+void irqEnable(uint32_t irq)
+{
+    NVIC_ICPR = 1 << irq; // Drop a stale request from before the handler was ready
+    NVIC_ISER = 1 << irq;
+}
+
+void irqDisable(uint32_t irq)
+{
+    NVIC_ICER = 1 << irq;
+}
@@ -0,0 +1,72 @@
+#ifndef IRQ_RP2040_H
+#define IRQ_RP2040_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// External interrupt numbers, vector table entry 16 + n
+#define TIMER_IRQ_0                 (0)
+#define TIMER_IRQ_1                 (1)
+#define TIMER_IRQ_2                 (2)
+#define TIMER_IRQ_3                 (3)
+#define PWM_IRQ_WRAP                (4)
+#define USBCTRL_IRQ                 (5)
+#define XIP_IRQ                     (6)
+#define PIO0_IRQ_0                  (7)
+#define PIO0_IRQ_1                  (8)
+#define PIO1_IRQ_0                  (9)
+#define PIO1_IRQ_1                  (10)
+#define DMA_IRQ_0                   (11)
+#define DMA_IRQ_1                   (12)
+#define IO_IRQ_BANK0                (13)
+#define IO_IRQ_QSPI                 (14)
+#define SIO_IRQ_PROC0               (15)
+#define SIO_IRQ_PROC1               (16)
+#define CLOCKS_IRQ                  (17)
+#define SPI0_IRQ                    (18)
+#define SPI1_IRQ                    (19)
+#define UART0_IRQ                   (20)
+#define UART1_IRQ                   (21)
+#define ADC_IRQ_FIFO                (22)
+#define I2C0_IRQ                    (23)
+#define I2C1_IRQ                    (24)
+#define RTC_IRQ                     (25)
+
+#define IRQ_COUNT                   (26)
+
+typedef void (*irqHandler)(void);
+
+// Copy the flash vector table into .ram_vector and point VTOR at it, called by resetHandler before SystemInit
+void irqInit(void);
+
+// Install a handler in the vector table of the calling core and return the previous one. Exception entry then only
+// fetches from SRAM, provided the handler is TIME_CRITICAL too.
+irqHandler irqSetHandler(uint32_t irq, irqHandler handler);
+
+// Priority 0 is the highest, the M0+ implements 4 levels
+void irqSetPriority(uint32_t irq, uint32_t priority);
+
+void irqEnable(uint32_t irq);
+void irqDisable(uint32_t irq);
+
+// Mask interrupts on this core and return the previous state, for short critical sections
+static inline uint32_t irqSave(void)
+{
+    uint32_t primask;
+    asm volatile ("mrs %0, primask\n cpsid i" : "=r"(primask) :: "memory");
+    return primask;
+}
+
+static inline void irqRestore(uint32_t primask)
+{
+    asm volatile ("msr primask, %0" :: "r"(primask) : "memory");
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
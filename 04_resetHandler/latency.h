@@ -0,0 +1,56 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+
+// Interrupt sources the harness in bench/latency.c fires
+#define LATENCY_NVIC                (0)     // RTC_IRQ pended in software, timed from the NVIC_ISPR write
+#define LATENCY_TIMER               (1)     // TIMER ALARM1, timed from a SysTick sample loop
+#define LATENCY_FIFO                (2)     // Word echoed back by core1 through the SIO FIFO, timed from a sample loop
+#define LATENCY_SOURCES             (3)
+
+// Where the vector table and the handler live
+#define LATENCY_FLASH               (0)
+#define LATENCY_SRAM                (1)
+
+// State of the XIP cache when the interrupt fires
+#define LATENCY_WARM                (0)
+#define LATENCY_COLD                (1)     // Flushed right before
+
+#define LATENCY_CASES               (LATENCY_SOURCES * 2 * 2)
+#define LATENCY_CASE(source, placement, cache)  (((source) * 2 + (placement)) * 2 + (cache))
+
+#define LATENCY_MAGIC               (0x6e74614c) // "Latn"
+#define LATENCY_BINS                (128)   // 1 cycle each, the last one also counts everything above
+
+// Entry latency distribution of one case in clk_sys cycles, from the event to the first SysTick read in the handler
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t resolution;    // Sample loop period for the sampled sources, the event is seen up to this much late
+    uint64_t sum;
+    uint32_t hist[LATENCY_BINS];
+} latencyResult;
+
+// Results in .noinit, dumped from SRAM and decoded by tools/latencyReport.cpp
+typedef struct
+{
+    uint32_t magic;
+    uint32_t cases;
+    latencyResult results[LATENCY_CASES];
+} latencyBuffer;
+
+static inline void latencyRecord(latencyResult *result, uint32_t cycles)
+{
+    if (!result->count || cycles < result->min)
+        result->min = cycles;
+    if (cycles > result->max)
+        result->max = cycles;
+    ++result->count;
+    result->sum += cycles;
+    ++result->hist[cycles < LATENCY_BINS ? cycles : LATENCY_BINS - 1];
+}
+
+#endif
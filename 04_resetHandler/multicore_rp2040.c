@@ -0,0 +1,180 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "irq_rp2040.h"
+#include "multicore_rp2040.h"
+#include "regs_rp2040.h"
+#include "sections.h"
+
+// Define necessary register addresses
+// SIO
+#define SIO_BASE                    (0xd0000000)
+#define SIO_CPUID                   (*(volatile uint32_t *) (SIO_BASE + 0x000))
+#define SIO_FIFO_ST                 (*(volatile uint32_t *) (SIO_BASE + 0x050))
+#define SIO_FIFO_WR                 (*(volatile uint32_t *) (SIO_BASE + 0x054))
+#define SIO_FIFO_RD                 (*(volatile uint32_t *) (SIO_BASE + 0x058))
+// PSM
+#define PSM_FRCE_OFF                (*(volatile uint32_t *) (0x40010004))
+// NVIC
+#define NVIC_ISER                   (*(volatile uint32_t *) (0xe000e100))
+#define NVIC_ICER                   (*(volatile uint32_t *) (0xe000e180))
+
+#define FIFO_ST_VLD                 (1 << 0)    // RX FIFO holds data
+#define FIFO_ST_RDY                 (1 << 1)    // TX FIFO has room
+#define PSM_PROC1                   (1 << 16)
+
+// SIO_IRQ_PROC0 and SIO_IRQ_PROC1 are interrupts 15 and 16, each raised by the FIFO of its own core
+#define SIO_IRQ_PROC(core)          (15 + (core))
+
+// Single producer, single consumer ring per receiving core. head and tail run freely and wrap.
+typedef struct
+{
+    volatile uint32_t head;         // Written by the sending core
+    volatile uint32_t tail;         // Written by the receiving core
+    volatile uint32_t notified;     // Set while a doorbell is on its way, cleared by the receiver before it drains
+    channelHandler handler;
+    uint32_t msgs[CHANNEL_SIZE];
+} channelRing;
+
+static channelRing rings[2];
+
+// Vector table copy of core1, VTOR needs it 256 byte aligned
+void (*core1Vector[48])(void) __attribute__((aligned(256)));
+extern void (*const vector[48])(void);
+
+extern uint32_t __core1_stack;
+static coreEntry core1Entry;
+
+static inline void memoryBarrier(void)
+{
+    asm volatile ("dmb" ::: "memory");
+}
+
+uint32_t coreNum(void)
+{
+    return SIO_CPUID;
+}
+
+static void fifoDrain(void)
+{
+    while (SIO_FIFO_ST & FIFO_ST_VLD)
+        (void)SIO_FIFO_RD;
+}
+
+static void fifoPush(uint32_t value)
+{
+    while (!(SIO_FIFO_ST & FIFO_ST_RDY));
+    SIO_FIFO_WR = value;
+    asm volatile ("sev"); // Wake the other core if it waits in WFE, e.g. the bootrom
+}
+
+static uint32_t fifoPop(void)
+{
+    while (!(SIO_FIFO_ST & FIFO_ST_VLD))
+        asm volatile ("wfe");
+    return SIO_FIFO_RD;
+}
+
+// First code core1 runs, with its stack and vector table already set up by the bootrom
+static void core1Start(void)
+{
+    core1Entry();
+    while (true)
+        asm volatile ("wfi"); // Nothing left to do but serve interrupts
+}
+
+void core1Launch(coreEntry entry)
+{
+    // Hold core1 in reset and release it, it then waits in the bootrom for the launch sequence
+    regSet(&PSM_FRCE_OFF, PSM_PROC1);
+    while (!(PSM_FRCE_OFF & PSM_PROC1));
+    regClear(&PSM_FRCE_OFF, PSM_PROC1);
+
+    for (uint32_t i = 0; i < 48; ++i)
+        core1Vector[i] = vector[i];
+    core1Entry = entry;
+    memoryBarrier();
+
+    // The handshake answers through the FIFO, keep the channel interrupt out of it
+    bool listening = NVIC_ISER & (1 << SIO_IRQ_PROC(0));
+    NVIC_ICER = 1 << SIO_IRQ_PROC(0);
+
+    // Every word is echoed back by the bootrom, on a mismatch the sequence starts over
+    const uint32_t cmds[] = {0, 0, 1, (uint32_t)core1Vector, (uint32_t)&__core1_stack, (uint32_t)core1Start};
+    for (uint32_t i = 0; i < sizeof(cmds) / sizeof(cmds[0]);)
+    {
+        if (!cmds[i])
+        {
+            fifoDrain();
+            asm volatile ("sev");
+        }
+        fifoPush(cmds[i]);
+        i = (fifoPop() == cmds[i]) ? i + 1 : 0;
+    }
+
+    if (listening)
+        NVIC_ISER = 1 << SIO_IRQ_PROC(0);
+}
+
+void channelListen(channelHandler handler)
+{
+    uint32_t core = coreNum();
+    rings[core].handler = handler;
+    fifoDrain();
+    SIO_FIFO_ST = 0; // Clear the sticky overflow and underflow flags
+    NVIC_ISER = 1 << SIO_IRQ_PROC(core);
+}
+
+uint32_t channelSend(const uint32_t *msgs, uint32_t count)
+{
+    channelRing *ring = &rings[coreNum() ^ 1];
+
+    // Threads and interrupts of this core may all send, they take turns being the single producer
+    uint32_t primask = irqSave();
+    uint32_t head = ring->head;
+    uint32_t space = CHANNEL_SIZE - (head - ring->tail);
+    if (count > space)
+        count = space;
+    for (uint32_t i = 0; i < count; ++i)
+        ring->msgs[(head + i) & (CHANNEL_SIZE - 1)] = msgs[i];
+    memoryBarrier(); // Messages before head
+    ring->head = head + count;
+    memoryBarrier(); // head before notified, pairs with the barrier in channelIrq
+
+    if (count && !ring->notified)
+    {
+        ring->notified = 1;
+        fifoPush(0); // The doorbell carries no data
+    }
+    irqRestore(primask);
+    return count;
+}
+
+// Drain the ring of this core and hand the messages over in contiguous runs
+static void channelIrq(uint32_t core)
+{
+    channelRing *ring = &rings[core];
+    fifoDrain();
+    SIO_FIFO_ST = 0;
+
+    ring->notified = 0;
+    memoryBarrier(); // Messages sent from here on ring the doorbell again
+    uint32_t tail = ring->tail;
+    uint32_t head;
+    while ((head = ring->head) != tail)
+    {
+        uint32_t index = tail & (CHANNEL_SIZE - 1);
+        uint32_t count = head - tail;
+        if (count > CHANNEL_SIZE - index)
+            count = CHANNEL_SIZE - index; // Up to the end of the buffer, the rest follows in the next run
+        memoryBarrier(); // head before messages
+        if (ring->handler)
+            ring->handler(&ring->msgs[index], count);
+        tail += count;
+        memoryBarrier(); // Messages consumed before the space is handed back
+        ring->tail = tail;
+    }
+}
+
+TIME_CRITICAL void sioIrqProc0() { channelIrq(0); }
+TIME_CRITICAL void sioIrqProc1() { channelIrq(1); }
@@ -0,0 +1,40 @@
+#ifndef MULTICORE_RP2040_H
+#define MULTICORE_RP2040_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Messages a channel buffers per direction, a power of two
+#define CHANNEL_SIZE                (64)
+
+typedef void (*coreEntry)(void);
+
+// Receives the messages that arrived since the last call, in order. Runs in the SIO interrupt of the receiving core.
+typedef void (*channelHandler)(const uint32_t *msgs, uint32_t count);
+
+// Number of the calling core, 0 or 1
+uint32_t coreNum(void);
+
+// Reset core1 and start entry on it through the bootrom FIFO handshake, from core0 only.
+// Core1 runs on the stack at __core1_stack and a copy of the vector table in SRAM, see core1Vector.
+void core1Launch(coreEntry entry);
+
+// Core1 vector table, set up by core1Launch before core1 starts and free to be patched afterwards
+extern void (*core1Vector[48])(void);
+
+// Deliver the messages sent to the calling core to handler, enables its SIO FIFO interrupt
+void channelListen(channelHandler handler);
+
+// Queue messages for the other core, returns how many fit. A batch costs a single FIFO doorbell
+// and a doorbell is only sent while the other core has not been notified already.
+uint32_t channelSend(const uint32_t *msgs, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,144 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "irq_rp2040.h"
+#include "profile_rp2040.h"
+#include "regs_rp2040.h"
+#include "sections.h"
+
+// Define necessary register addresses
+// TIMER
+#define TIMER_BASE                  (0x40054000)
+#define TIMER_ALARM3                (*(volatile uint32_t *) (TIMER_BASE + 0x01c))
+#define TIMER_ARMED                 (*(volatile uint32_t *) (TIMER_BASE + 0x020))
+#define TIMER_TIMERAWL              (*(volatile uint32_t *) (TIMER_BASE + 0x028))
+#define TIMER_INTR                  (*(volatile uint32_t *) (TIMER_BASE + 0x034))
+#define TIMER_INTE                  (*(volatile uint32_t *) (TIMER_BASE + 0x038))
+
+// Exception frame stacked by the hardware, in words
+#define FRAME_LR                    (5)
+#define FRAME_PC                    (6)
+
+// Linker provided boundaries of the code
+extern uint32_t _stext, _etext, _stime_critical, _etime_critical;
+
+profileBuffer profileBuf __attribute__((section(".noinit")));
+
+static uint32_t period;
+static uint32_t nextSample;
+static uint32_t jitter = 1;
+
+// Smallest bucket size that covers [start, end) with the given number of buckets
+static uint32_t bucketShift(uint32_t start, uint32_t end, uint32_t buckets)
+{
+    uint32_t shift = 1; // Thumb instructions are at least 2 byte aligned
+    while (((end - start) >> shift) >= buckets)
+        ++shift;
+    return shift;
+}
+
+static void countEdge(uint32_t from, uint32_t to)
+{
+    uint32_t hash = ((from ^ (to * 0x9e3779b1u)) * 0x9e3779b1u) >> 24;
+    for (uint32_t probe = 0; probe < 8; ++probe)
+    {
+        profileEdge *edge = &profileBuf.edges[(hash + probe) & (PROFILE_EDGES - 1)];
+        if (!edge->count)
+        {
+            edge->from = from;
+            edge->to = to;
+        }
+        else if (edge->from != from || edge->to != to)
+            continue;
+        ++edge->count;
+        return;
+    }
+    ++profileBuf.edgesDropped;
+}
+
+// Called by profileIrq with the exception frame of whatever was interrupted
+TIME_CRITICAL void profileSample(uint32_t *frame)
+{
+    TIMER_INTR = 1 << 3;
+
+    // Rearm first, the next period is dithered by up to 1/8 so sampling does not lock onto periodic code
+    jitter ^= jitter << 13;
+    jitter ^= jitter >> 17;
+    jitter ^= jitter << 5;
+    nextSample += period + (jitter & (period >> 3));
+    if ((int32_t)(nextSample - TIMER_TIMERAWL) <= 0)
+        nextSample = TIMER_TIMERAWL + period; // Fell behind, e.g. held back by another handler
+    TIMER_ALARM3 = nextSample;
+
+    uint32_t pc = frame[FRAME_PC], lr = frame[FRAME_LR] & ~1;
+    uint32_t to;
+    ++profileBuf.samples;
+    if (pc - profileBuf.flashStart < (uint32_t)&_etext - profileBuf.flashStart)
+    {
+        uint32_t bucket = (pc - profileBuf.flashStart) >> profileBuf.flashShift;
+        if (profileBuf.flash[bucket] != UINT16_MAX)
+            ++profileBuf.flash[bucket];
+        to = profileBuf.flashStart + (bucket << profileBuf.flashShift);
+    }
+    else if (pc - profileBuf.sramStart < (uint32_t)&_etime_critical - profileBuf.sramStart)
+    {
+        uint32_t bucket = (pc - profileBuf.sramStart) >> profileBuf.sramShift;
+        if (profileBuf.sram[bucket] != UINT16_MAX)
+            ++profileBuf.sram[bucket];
+        to = profileBuf.sramStart + (bucket << profileBuf.sramShift);
+    }
+    else
+    {
+        ++profileBuf.other;
+        return;
+    }
+    countEdge(lr, to);
+}
+
+// The frame is on the process stack if the interrupted code ran on it, EXC_RETURN bit 2 tells.
+// profileSample is entered by a tail call, so it returns straight from the exception with lr still EXC_RETURN.
+__attribute__((naked)) TIME_CRITICAL static void profileIrq(void)
+{
+    asm volatile (
+        "   movs r0, #4                 \n"
+        "   mov r1, lr                  \n"
+        "   tst r0, r1                  \n"
+        "   beq 1f                      \n"
+        "   mrs r0, psp                 \n"
+        "   b 2f                        \n"
+        "1: mrs r0, msp                 \n"
+        "2: ldr r1, 3f                  \n"
+        "   bx r1                       \n"
+        "   .align 2                    \n"
+        "3: .word profileSample         \n");
+}
+
+void profileStart(uint32_t periodUs)
+{
+    profileStop();
+
+    uint8_t *raw = (uint8_t *)&profileBuf;
+    for (uint32_t i = 0; i < sizeof(profileBuf); ++i)
+        raw[i] = 0;
+    profileBuf.magic = PROFILE_MAGIC;
+    profileBuf.flashStart = (uint32_t)&_stext;
+    profileBuf.flashShift = bucketShift((uint32_t)&_stext, (uint32_t)&_etext, PROFILE_FLASH_BUCKETS);
+    profileBuf.sramStart = (uint32_t)&_stime_critical;
+    profileBuf.sramShift = bucketShift((uint32_t)&_stime_critical, (uint32_t)&_etime_critical, PROFILE_SRAM_BUCKETS);
+
+    period = periodUs;
+    irqSetHandler(TIMER_IRQ_3, profileIrq);
+    irqSetPriority(TIMER_IRQ_3, 0);
+    regSet(&TIMER_INTE, 1 << 3);
+    irqEnable(TIMER_IRQ_3);
+    nextSample = TIMER_TIMERAWL + period;
+    TIMER_ALARM3 = nextSample;
+}
+
+void profileStop(void)
+{
+    irqDisable(TIMER_IRQ_3);
+    TIMER_ARMED = 1 << 3; // Disarm
+    regClear(&TIMER_INTE, 1 << 3);
+    TIMER_INTR = 1 << 3;
+}
@@ -0,0 +1,47 @@
+#ifndef PROFILE_RP2040_H
+#define PROFILE_RP2040_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PROFILE_MAGIC               (0x666f7250) // "Prof"
+#define PROFILE_FLASH_BUCKETS       (1024)  // Histogram over the flash .text, the bucket size adapts to fit it
+#define PROFILE_SRAM_BUCKETS        (256)   // Histogram over .time_critical
+#define PROFILE_EDGES               (256)   // Call edges from the stacked LR to the stacked PC, a power of two
+
+typedef struct
+{
+    uint32_t from;      // Stacked LR without the Thumb bit, the return address in the caller
+    uint32_t to;        // Start of the histogram bucket the stacked PC fell into
+    uint32_t count;
+} profileEdge;
+
+// Samples in .noinit, dumped from SRAM and symbolized by tools/profReport.cpp
+typedef struct
+{
+    uint32_t magic;
+    uint32_t samples;
+    uint32_t flashStart, flashShift;    // Flash bucket n covers flashStart + (n << flashShift) onwards
+    uint32_t sramStart, sramShift;      // Same for SRAM
+    uint32_t other;                     // PCs outside both, e.g. in the bootrom
+    uint32_t edgesDropped;              // Edges that found the table full
+    uint16_t flash[PROFILE_FLASH_BUCKETS];  // Saturating counts
+    uint16_t sram[PROFILE_SRAM_BUCKETS];
+    profileEdge edges[PROFILE_EDGES];
+} profileBuffer;
+
+extern profileBuffer profileBuf;
+
+// Clear profileBuf and sample the interrupted PC and LR on TIMER ALARM3 about every periodUs. Handlers of the same
+// NVIC priority as TIMER_IRQ_3 hold the sample back until they return, lower their priority to see inside them.
+void profileStart(uint32_t periodUs);
+void profileStop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
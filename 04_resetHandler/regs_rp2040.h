@@ -0,0 +1,263 @@
+#ifndef REGS_RP2040_H
+#define REGS_RP2040_H
+
+#include <stdint.h>
+
+// Typed register access for C++. Every register is its own type, so an access compiles to a single load or store
+// with the address as a literal. Peripherals decode four views of each register: normal at +0x0000, XOR at +0x1000,
+// set at +0x2000 and clear at +0x3000. set(), clear() and toggle() are one store to the matching view, which takes
+// half the bus transactions of a read-modify-write and cannot lose an update made by an interrupt or the other core.
+// SIO has no such views, its GPIO registers come with SET, CLR and XOR registers of their own instead.
+#define REGS_ALIAS_XOR              (0x1000)
+#define REGS_ALIAS_SET              (0x2000)
+#define REGS_ALIAS_CLR              (0x3000)
+
+#ifndef __cplusplus
+// C face of the layer for the C modules, which keep their register macros and pass them by address, e.g.
+// regClear(&RESETS_RESET, 1 << 5). Each is the same single store to the alias view as set(), clear() and toggle().
+static inline void regSet(volatile uint32_t *reg, uint32_t bits)
+{
+    *(volatile uint32_t *)((uintptr_t)reg + REGS_ALIAS_SET) = bits;
+}
+
+static inline void regClear(volatile uint32_t *reg, uint32_t bits)
+{
+    *(volatile uint32_t *)((uintptr_t)reg + REGS_ALIAS_CLR) = bits;
+}
+
+static inline void regToggle(volatile uint32_t *reg, uint32_t bits)
+{
+    *(volatile uint32_t *)((uintptr_t)reg + REGS_ALIAS_XOR) = bits;
+}
+#else
+namespace regs
+{
+#ifdef HOST_MODEL
+    // Provided by the host model, e.g. ../bench/regsHost.cpp, which records every access
+    uint32_t busRead(uint32_t addr);
+    void busWrite(uint32_t addr, uint32_t value);
+#else
+    inline uint32_t busRead(uint32_t addr) { return *(volatile uint32_t *)addr; }
+    inline void busWrite(uint32_t addr, uint32_t value) { *(volatile uint32_t *)addr = value; }
+#endif
+
+    constexpr uint32_t aliasXor = REGS_ALIAS_XOR;
+    constexpr uint32_t aliasSet = REGS_ALIAS_SET;
+    constexpr uint32_t aliasClr = REGS_ALIAS_CLR;
+
+    // Bit field of a register
+    struct field
+    {
+        uint32_t shift, width;
+
+        constexpr uint32_t mask() const { return (width >= 32 ? 0xffffffff : (1u << width) - 1) << shift; }
+        // Value placed in the field, e.g. pll::primPostDiv1(6)
+        constexpr uint32_t operator()(uint32_t value) const { return (value << shift) & mask(); }
+    };
+
+    template <uint32_t address, bool aliased = true>
+    struct reg
+    {
+        static constexpr uint32_t addr = address;
+
+        static uint32_t read() { return busRead(addr); }
+        static void write(uint32_t value) { busWrite(addr, value); }
+
+        static void set(uint32_t bits)
+        {
+            static_assert(aliased, "No atomic aliases for this register, write its SET register instead");
+            busWrite(addr + aliasSet, bits);
+        }
+
+        static void clear(uint32_t bits)
+        {
+            static_assert(aliased, "No atomic aliases for this register, write its CLR register instead");
+            busWrite(addr + aliasClr, bits);
+        }
+
+        static void toggle(uint32_t bits)
+        {
+            static_assert(aliased, "No atomic aliases for this register, write its XOR register instead");
+            busWrite(addr + aliasXor, bits);
+        }
+
+        static uint32_t get(field f) { return (read() & f.mask()) >> f.shift; }
+
+        // Replace one field. Only the bits that differ are flipped through the XOR view, so bits outside the field
+        // are never written back stale. The read and the flip are not one operation, the field itself needs an owner.
+        static void modify(field f, uint32_t value)
+        {
+            static_assert(aliased, "No atomic aliases for this register, use read() and write()");
+            busWrite(addr + aliasXor, (read() ^ f(value)) & f.mask());
+        }
+
+        // Spin until all of bits read as 1
+        static void waitSet(uint32_t bits) { while ((read() & bits) != bits); }
+    };
+
+    namespace resets
+    {
+        constexpr uint32_t base = 0x4000c000;
+        constexpr reg<base + 0x000> reset{};
+        constexpr reg<base + 0x004> wdsel{};
+        constexpr reg<base + 0x008> resetDone{};
+
+        // Bits of reset and resetDone
+        constexpr uint32_t dma = 1 << 2;
+        constexpr uint32_t ioBank0 = 1 << 5;
+        constexpr uint32_t padsBank0 = 1 << 8;
+        constexpr uint32_t pllSys = 1 << 12;
+        constexpr uint32_t pllUsb = 1 << 13;
+        constexpr uint32_t timer = 1 << 21;
+
+        // Take blocks out of reset and wait until they respond
+        inline void unreset(uint32_t blocks)
+        {
+            reset.clear(blocks);
+            resetDone.waitSet(blocks);
+        }
+    }
+
+    namespace xosc
+    {
+        constexpr uint32_t base = 0x40024000;
+        constexpr reg<base + 0x000> ctrl{};
+        constexpr reg<base + 0x004> status{};
+        constexpr reg<base + 0x00c> startup{};
+
+        constexpr field ctrlFreqRange{0, 12};
+        constexpr field ctrlEnable{12, 12};
+        constexpr uint32_t freqRange1To15MHz = 0xaa0;
+        constexpr uint32_t enableMagic = 0xfab;
+        constexpr uint32_t disableMagic = 0xd1e;
+        constexpr uint32_t statusStable = 1u << 31;
+    }
+
+    namespace rosc
+    {
+        constexpr uint32_t base = 0x40060000;
+        constexpr reg<base + 0x000> ctrl{};
+
+        constexpr field ctrlEnable{12, 12};
+        constexpr uint32_t disableMagic = 0xd1e;
+    }
+
+    namespace pll
+    {
+        // PLL_SYS and PLL_USB share one layout
+        template <uint32_t base>
+        struct block
+        {
+            static constexpr reg<base + 0x000> cs{};
+            static constexpr reg<base + 0x004> pwr{};
+            static constexpr reg<base + 0x008> fbDivInt{};
+            static constexpr reg<base + 0x00c> prim{};
+        };
+
+        constexpr block<0x40028000> sys{};
+        constexpr block<0x4002c000> usb{};
+
+        constexpr field csRefDiv{0, 6};
+        constexpr uint32_t csLock = 1u << 31;
+        constexpr uint32_t pwrPd = 1 << 0;          // Main power down
+        constexpr uint32_t pwrPostDivPd = 1 << 3;
+        constexpr uint32_t pwrVcoPd = 1 << 5;
+        constexpr field primPostDiv2{12, 3};
+        constexpr field primPostDiv1{16, 3};
+    }
+
+    namespace clocks
+    {
+        constexpr uint32_t base = 0x40008000;
+        constexpr reg<base + 0x030> refCtrl{};
+        constexpr reg<base + 0x038> refSelected{};
+        constexpr reg<base + 0x03c> sysCtrl{};
+        constexpr reg<base + 0x044> sysSelected{};
+        constexpr reg<base + 0x048> periCtrl{};
+        constexpr reg<base + 0x054> usbCtrl{};
+        constexpr reg<base + 0x060> adcCtrl{};
+
+        // Fields of the CTRL registers, the glitchless mux of clk_ref and clk_sys and the aux mux of all
+        constexpr field ctrlSrc{0, 2};
+        constexpr field ctrlAuxSrc{5, 3};
+        constexpr uint32_t ctrlEnable = 1 << 11;
+
+        constexpr uint32_t refSrcXosc = 2;
+        constexpr uint32_t sysSrcAux = 1;           // The aux mux of clk_sys defaults to PLL_SYS
+        constexpr uint32_t periAuxSrcClkSys = 0;
+        constexpr uint32_t usbAuxSrcPllUsb = 0;     // Also for clk_adc
+    }
+
+    namespace watchdog
+    {
+        constexpr uint32_t base = 0x40058000;
+        constexpr reg<base + 0x02c> tick{};
+
+        constexpr field tickCycles{0, 9};
+    }
+
+    namespace timer
+    {
+        constexpr uint32_t base = 0x40054000;
+        template <uint32_t n>
+        constexpr reg<base + 0x010 + 4 * n> alarm{};
+        constexpr reg<base + 0x020> armed{};
+        constexpr reg<base + 0x024> timeRawH{};
+        constexpr reg<base + 0x028> timeRawL{};
+        constexpr reg<base + 0x034> intr{};
+        constexpr reg<base + 0x038> inte{};
+        constexpr reg<base + 0x03c> intf{};
+        constexpr reg<base + 0x040> ints{};
+    }
+
+    namespace ioBank0
+    {
+        constexpr uint32_t base = 0x40014000;
+        template <uint32_t gpio>
+        constexpr reg<base + 8 * gpio + 0x000> gpioStatus{};
+        template <uint32_t gpio>
+        constexpr reg<base + 8 * gpio + 0x004> gpioCtrl{};
+
+        constexpr field ctrlFuncSel{0, 5};
+        constexpr uint32_t funcSio = 5;
+    }
+
+    namespace sio
+    {
+        constexpr uint32_t base = 0xd0000000;
+        constexpr reg<base + 0x000, false> cpuid{};
+        constexpr reg<base + 0x004, false> gpioIn{};
+        constexpr reg<base + 0x010, false> gpioOut{};
+        constexpr reg<base + 0x014, false> gpioOutSet{};
+        constexpr reg<base + 0x018, false> gpioOutClr{};
+        constexpr reg<base + 0x01c, false> gpioOutXor{};
+        constexpr reg<base + 0x020, false> gpioOe{};
+        constexpr reg<base + 0x024, false> gpioOeSet{};
+        constexpr reg<base + 0x028, false> gpioOeClr{};
+        constexpr reg<base + 0x02c, false> gpioOeXor{};
+    }
+
+    // The SSI sits behind the XIP block, which does not document the alias views, so it only gets plain access
+    namespace ssi
+    {
+        constexpr uint32_t base = 0x18000000;
+        constexpr reg<base + 0x000, false> ctrlr0{};
+        constexpr reg<base + 0x004, false> ctrlr1{};
+        constexpr reg<base + 0x008, false> ssienr{};
+        constexpr reg<base + 0x014, false> baudr{};
+        constexpr reg<base + 0x028, false> sr{};
+        constexpr reg<base + 0x0f0, false> rxSampleDly{};
+        constexpr reg<base + 0x0f4, false> spiCtrlr0{};
+
+        constexpr uint32_t srBusy = 1 << 0;
+    }
+
+    // Layout checks, done whenever this header is compiled
+    static_assert(field{16, 3}(6) == (6 << 16) && field{0, 32}.mask() == 0xffffffff, "Field descriptors are broken");
+    static_assert(ioBank0::gpioCtrl<25>.addr == 0x400140cc, "IO_BANK0 layout is broken");
+    static_assert(pll::sys.prim.addr == 0x4002800c && pll::usb.pwr.addr == 0x4002c004, "PLL layout is broken");
+    static_assert(timer::alarm<3>.addr == 0x4005401c, "TIMER layout is broken");
+}
+#endif
+
+#endif
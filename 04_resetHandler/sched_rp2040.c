@@ -0,0 +1,240 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "irq_rp2040.h"
+#include "sched_rp2040.h"
+#include "sections.h"
+
+// Define necessary register addresses
+// SCB
+#define SCB_ICSR                    (*(volatile uint32_t *) (0xe000ed04))
+#define SCB_SHPR3                   (*(volatile uint32_t *) (0xe000ed20))
+// SysTick
+#define SYST_CSR                    (*(volatile uint32_t *) (0xe000e010))
+#define SYST_RVR                    (*(volatile uint32_t *) (0xe000e014))
+#define SYST_CVR                    (*(volatile uint32_t *) (0xe000e018))
+
+#define ICSR_PENDSVSET              (1 << 28)
+
+#ifndef CLK_SYS_HZ
+#define CLK_SYS_HZ                  (100000000)
+#endif
+
+#if CLK_SYS_HZ / 1000000 * SCHED_TICK_US > 0x1000000
+#error "SCHED_TICK_US does not fit the 24-bit SysTick reload value"
+#endif
+
+// Handlers run on their own stack once the threads have moved to the process stack
+#define HANDLER_STACK_WORDS         (256)
+
+// Initial xPSR of a thread, only the Thumb bit is set
+#define XPSR_THUMB                  (1 << 24)
+
+// Running thread and the one pendSvHandler switches to. The assembly relies on this layout.
+struct
+{
+    thread *current;
+    thread *next;
+} schedState;
+
+static thread *readyTail[SCHED_PRIORITIES];     // Last thread of each circular ready queue, its next is the head
+static uint32_t readyMask;                      // Bit n is set while priority n has a ready thread
+static thread idleThread;
+
+THREAD_STACK(handlerStack, HANDLER_STACK_WORDS);
+
+// Index of the lowest set bit, the M0+ has no CLZ, so isolate the bit and look it up with a de Bruijn multiply
+static inline uint32_t lowestBit(uint32_t x)
+{
+    static const uint8_t deBruijn[32] =
+    {
+        0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+        31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+    };
+    return deBruijn[((x & -x) * 0x077cb531u) >> 27];
+}
+
+// The ready queues are only touched with interrupts masked. The running thread always is the head of its queue.
+static void readyPush(thread *t)
+{
+    thread *tail = readyTail[t->priority];
+    if (tail)
+    {
+        t->next = tail->next;
+        tail->next = t;
+    }
+    else
+    {
+        t->next = t;
+        readyMask |= 1 << t->priority;
+    }
+    readyTail[t->priority] = t;
+}
+
+static void readyPopHead(uint32_t priority)
+{
+    thread *tail = readyTail[priority];
+    thread *head = tail->next;
+    if (head == tail)
+    {
+        readyTail[priority] = 0;
+        readyMask &= ~(1 << priority);
+    }
+    else
+        tail->next = head->next;
+}
+
+// Pick the head of the highest priority ready queue and pend a switch to it if it is not running already
+static void reschedule(void)
+{
+    if (!schedState.current)
+        return; // Not started yet
+    thread *next = readyTail[lowestBit(readyMask)]->next;
+    schedState.next = next;
+    if (next != schedState.current)
+        SCB_ICSR = ICSR_PENDSVSET;
+}
+
+// PendSV runs at the lowest priority, so it only ever interrupts thread code and the hardware has already stacked
+// r0 - r3, r12, lr, pc and xPSR on the process stack. Thumb-1 has no stmdb and ldm/stm only reach r0 - r7,
+// so r4 - r11 are stored upwards from 32 bytes below the hardware frame, r8 - r11 by way of r4 - r7.
+__attribute__((naked)) TIME_CRITICAL void pendSvHandler(void)
+{
+    asm volatile (
+        "   mrs r0, psp                 \n"
+        "   subs r0, #32                \n"
+        "   ldr r2, 1f                  \n" // &schedState
+        "   ldr r1, [r2]                \n"
+        "   str r0, [r1]                \n" // schedState.current->sp
+        "   stmia r0!, {r4-r7}          \n"
+        "   mov r4, r8                  \n"
+        "   mov r5, r9                  \n"
+        "   mov r6, r10                 \n"
+        "   mov r7, r11                 \n"
+        "   stmia r0!, {r4-r7}          \n"
+        "   ldr r1, [r2, #4]            \n" // schedState.next
+        "   str r1, [r2]                \n"
+        "   ldr r0, [r1]                \n" // schedState.next->sp
+        "   adds r0, #16                \n"
+        "   ldmia r0!, {r4-r7}          \n"
+        "   mov r8, r4                  \n"
+        "   mov r9, r5                  \n"
+        "   mov r10, r6                 \n"
+        "   mov r11, r7                 \n"
+        "   msr psp, r0                 \n"
+        "   subs r0, #32                \n"
+        "   ldmia r0!, {r4-r7}          \n"
+        "   bx lr                       \n" // EXC_RETURN to thread mode on the process stack
+        "   .align 2                    \n"
+        "1: .word schedState            \n");
+}
+
+#if SCHED_TICK_US
+// Time slice expired, move the running thread behind the others of its priority
+void sysTickHandler(void)
+{
+    uint32_t primask = irqSave();
+    thread *current = schedState.current;
+    thread *tail = readyTail[current->priority];
+    if (tail != current && tail->next == current)
+        readyTail[current->priority] = current;
+    reschedule();
+    irqRestore(primask);
+}
+#endif
+
+void threadCreate(thread *t, threadEntry entry, void *arg, uint32_t *stack, uint32_t stackWords, uint32_t priority)
+{
+    // Exception frames are 8 byte aligned
+    uint32_t *sp = (uint32_t *)((uintptr_t)(stack + stackWords) & ~7);
+
+    // Frame the first switch to the thread unstacks, entry is entered with arg in r0 and returns into threadExit
+    sp -= 8;
+    sp[0] = (uint32_t)arg;                      // r0
+    sp[1] = sp[2] = sp[3] = sp[4] = 0;          // r1 - r3, r12
+    sp[5] = (uint32_t)threadExit;               // lr
+    sp[6] = (uint32_t)entry & ~1;               // pc, without the Thumb bit
+    sp[7] = XPSR_THUMB;                         // xPSR
+    sp -= 8;
+    for (uint32_t i = 0; i < 8; ++i)            // r4 - r11
+        sp[i] = 0;
+
+    t->sp = sp;
+    t->priority = priority;
+    t->timer = (swTimer){0};
+
+    uint32_t primask = irqSave();
+    readyPush(t);
+    reschedule();
+    irqRestore(primask);
+}
+
+void schedStart(void)
+{
+    SCB_SHPR3 = (3u << 30) | (3u << 22); // SysTick and PendSV at the lowest priority, a switch never preempts a handler
+
+    uint32_t primask = irqSave();
+    idleThread.priority = SCHED_IDLE_PRIORITY;
+    readyPush(&idleThread);
+    schedState.current = schedState.next = &idleThread;
+
+    // The caller keeps its stack as the process stack of the idle thread, handlers move to handlerStack
+    asm volatile (
+        "   mrs r0, msp                 \n"
+        "   msr psp, r0                 \n"
+        "   movs r0, #2                 \n"
+        "   msr control, r0             \n" // SPSEL, thread mode uses PSP from here on
+        "   isb                         \n"
+        "   msr msp, %0                 \n"
+        :: "r"(handlerStack + HANDLER_STACK_WORDS) : "r0", "memory");
+
+#if SCHED_TICK_US
+    SYST_RVR = CLK_SYS_HZ / 1000000 * SCHED_TICK_US - 1;
+    SYST_CVR = 0; // Clear current value, it is reloaded on the first tick
+    SYST_CSR = (1 << 2) | (1 << 1) | (1 << 0); // Processor clock, interrupt, enable
+#endif
+
+    reschedule();
+    irqRestore(primask); // Threads created before start run from here on
+}
+
+void threadYield(void)
+{
+    uint32_t primask = irqSave();
+    thread *current = schedState.current;
+    readyTail[current->priority] = current; // The head becomes the tail
+    reschedule();
+    irqRestore(primask);
+}
+
+static void threadWake(void *arg)
+{
+    uint32_t primask = irqSave();
+    readyPush((thread *)arg);
+    reschedule();
+    irqRestore(primask);
+}
+
+void threadSleep(uint64_t us)
+{
+    uint32_t primask = irqSave();
+    thread *current = schedState.current;
+    readyPopHead(current->priority);
+    swTimerStart(&current->timer, readTime() + us, threadWake, current);
+    reschedule();
+    irqRestore(primask); // PendSV switches away here and returns once threadWake made the thread ready again
+}
+
+void threadExit(void)
+{
+    irqSave();
+    readyPopHead(schedState.current->priority);
+    reschedule();
+    irqRestore(0);
+    while (true); // Not reached, PendSV never switches back
+}
+
+thread *threadSelf(void)
+{
+    return schedState.current;
+}
@@ -0,0 +1,57 @@
+#ifndef SCHED_RP2040_H
+#define SCHED_RP2040_H
+
+#include <stdint.h>
+
+#include "timer_rp2040.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Priority 0 is the highest, SCHED_PRIORITIES - 1 belongs to the idle thread
+#define SCHED_PRIORITIES            (32)
+#define SCHED_IDLE_PRIORITY         (SCHED_PRIORITIES - 1)
+
+// Time slice for threads of equal priority in us, 0 selects tickless mode where they only switch on
+// threadYield or threadSleep and SysTick stays unused
+#ifndef SCHED_TICK_US
+#define SCHED_TICK_US               (1000)
+#endif
+
+// Thread stacks live in their own NOLOAD section of link.ld, so resetHandler does not spend time zeroing them
+#define THREAD_STACK(name, words)   static uint32_t name[words] __attribute__((section(".thread_stacks"), aligned(8)))
+
+typedef void (*threadEntry)(void *arg);
+
+// Thread control block, owned by the caller and valid for as long as the thread exists
+typedef struct thread
+{
+    uint32_t *sp;               // Saved process stack pointer, must stay first for pendSvHandler
+    struct thread *next;        // Next thread in the circular ready queue of the same priority
+    uint32_t priority;
+    swTimer timer;              // Wakes the thread from threadSleep
+} thread;
+
+// Set up a thread and make it ready, from main before schedStart or from any thread afterwards.
+// Returning from entry ends the thread like threadExit.
+void threadCreate(thread *t, threadEntry entry, void *arg, uint32_t *stack, uint32_t stackWords, uint32_t priority);
+
+// Start scheduling, the caller carries on as the idle thread at SCHED_IDLE_PRIORITY and must never block
+void schedStart(void);
+
+// Move the running thread to the back of its ready queue
+void threadYield(void);
+
+// Block the running thread for at least us microseconds, lower priority threads run meanwhile
+void threadSleep(uint64_t us);
+
+__attribute__((noreturn)) void threadExit(void);
+
+thread *threadSelf(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef SECTIONS_H
+#define SECTIONS_H
+
+// Place a function in SRAM. It is linked into .data, so resetHandler copies it from flash together with the
+// initialized variables. Calls between flash and SRAM go through linker generated veneers and any library
+// helpers the compiler calls, e.g. for floating point, still run from flash. Integer division is the exception,
+// divider_rp2040.c places its helpers here. Each function gets an input section of its own, named after its line,
+// so --gc-sections drops the unused ones one by one as -ffunction-sections does for .text.
+#define SECTIONS_STR(x)             #x
+#define SECTIONS_XSTR(x)            SECTIONS_STR(x)
+#define TIME_CRITICAL               __attribute__((noinline, section(".time_critical." SECTIONS_XSTR(__LINE__))))
+
+// Place a variable in the 16kB of XIP cache memory. Doing so turns the cache off for good, see xip_rp2040.h, so
+// every instruction fetch from flash goes out over QSPI. Zeroed by resetHandler, initializers are not supported.
+#define XIP_SRAM                    __attribute__((section(".xip_sram")))
+
+#endif
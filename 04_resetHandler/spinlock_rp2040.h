@@ -0,0 +1,35 @@
+#ifndef SPINLOCK_RP2040_H
+#define SPINLOCK_RP2040_H
+
+#include <stdint.h>
+
+#include "irq_rp2040.h"
+
+// SIO hardware spinlocks, reading claims a lock and returns nonzero on success, writing releases it
+#define SIO_SPINLOCK(n)             (*(volatile uint32_t *) (0xd0000100 + 4 * (n)))
+
+// Lock assignment, there are 32 of them
+#define SPINLOCK_TASK_DEQUE(core)   (0 + (core))    // Task pool deque of core 0 and 1
+#define SPINLOCK_TASK_COUNTER       (2)             // Task pool completion counters
+#define SPINLOCK_DMA_CLAIM          (3)             // DMA channel claims
+#define SPINLOCK_ATOMIC(stripe)     (16 + (stripe)) // Striped locks of atomic_rp2040.c, 16 - 31
+#define SPINLOCK_ATOMIC_STRIPES     (16)
+
+// Take a lock with interrupts masked on this core, so it is never held across a handler that wants it too.
+// Returns the interrupt state for spinUnlock.
+static inline uint32_t spinLock(uint32_t lock)
+{
+    uint32_t primask = irqSave();
+    while (!SIO_SPINLOCK(lock));
+    asm volatile ("dmb" ::: "memory"); // Nothing inside the lock is read before it is taken
+    return primask;
+}
+
+static inline void spinUnlock(uint32_t lock, uint32_t primask)
+{
+    asm volatile ("dmb" ::: "memory"); // Everything inside the lock is written before it is released
+    SIO_SPINLOCK(lock) = 0;
+    irqRestore(primask);
+}
+
+#endif
@@ -1,14 +1,38 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "bootTrace.h"
+#include "regs_rp2040.h"
+#include "xip_rp2040.h"
+
+#if defined(BOOT_TRACE) && defined(STARTUP_CYCLES)
+#error "BOOT_TRACE and STARTUP_CYCLES both use SysTick, select only one"
+#endif
+
 // Type of vector table entry
 typedef void (*vectFunc) (void);
 
+// Type of constructor table entry
+typedef void (*initFunc) (void);
+
 // Declare the initial stack pointer, the value will be provided by the linker
 extern uint32_t __stack, _sdata, _edata, _sdataf;
 
+// Declare the boundaries of .xip_sram, the values will be provided by the linker
+extern uint32_t __xip_sram_start, __xip_sram_end;
+
+#ifdef STARTUP_LIBGLOSS
 // Declare _start function from libgloss
 extern void _start(void);
+#else
+// Declare .bss and constructor table boundaries, the values will be provided by the linker
+extern uint32_t __bss_start__, __bss_end__;
+extern initFunc __preinit_array_start[], __preinit_array_end[];
+extern initFunc __init_array_start[], __init_array_end[];
+
+// Normally provided by crtbegin.o, which isn't linked with -nostartfiles. Needed by C++ objects with destructors.
+void *__dso_handle = 0;
+#endif
 
 // Declare interrupt functions defined in this file
 __attribute__((noreturn)) void defaultHandler();
@@ -49,8 +73,9 @@ void i2c0Irq            () __attribute__((weak, alias("defaultHandler")));
 void i2c1Irq            () __attribute__((weak, alias("defaultHandler")));
 void rtcIrq             () __attribute__((weak, alias("defaultHandler")));
 
-// Declare SystemInit function
+// Declare SystemInit and irqInit functions
 extern void SystemInit(void);
+extern void irqInit(void);
 
 // Declare usSleep function
 extern void usSleep(uint64_t us);
@@ -111,17 +136,121 @@ const vectFunc vector[48] __attribute__((section(".vector"))) =
     0,                      // ExternalInterrupt[31]    = Reserved
 };
 
+// SysTick, used to count the cycles spent in the C runtime startup
+#define SYST_CSR                                        *(volatile uint32_t *) (0xe000e010)
+#define SYST_RVR                                        *(volatile uint32_t *) (0xe000e014)
+#define SYST_CVR                                        *(volatile uint32_t *) (0xe000e018)
+
+#ifdef BOOT_TRACE
+// Boot phase timeline, started by boot2. Decode a RAM dump with tools/bootTrace.
+bootTraceBuffer bootTraceBuf __attribute__((section(".noinit")));
+#endif
+
+#ifdef STARTUP_CYCLES
+// Cycles from reset to main, without SystemInit that only waits on XOSC and PLL. Read it with the debugger.
+volatile uint32_t startupCycles;
+
+void startupCyclesStop()
+{
+    SYST_CSR = 0; // Stop SysTick
+    startupCycles = 0xffffff - SYST_CVR;
+}
+#endif
+
+#ifndef STARTUP_LIBGLOSS
+// Copy words from src to dst up to end, 4 words per ldm/stm pair
+static inline __attribute__((always_inline)) void copyWords(uint32_t *dst, uint32_t *end, const uint32_t *src)
+{
+    uint32_t *burstEnd = dst + ((end - dst) & ~3);
+    asm volatile (
+        "   cmp %[dst], %[burstEnd]     \n"
+        "   beq 2f                      \n"
+        "1: ldmia %[src]!, {r3-r6}      \n"
+        "   stmia %[dst]!, {r3-r6}      \n"
+        "   cmp %[dst], %[burstEnd]     \n"
+        "   bne 1b                      \n"
+        "2:                             \n"
+        : [dst] "+l"(dst), [src] "+l"(src)
+        : [burstEnd] "l"(burstEnd)
+        : "r3", "r4", "r5", "r6", "cc", "memory");
+    while (dst < end) // Remaining 0 - 3 words
+        *dst++ = *src++;
+}
+
+// Zero words from dst up to end, 4 words per stm
+static inline __attribute__((always_inline)) void zeroWords(uint32_t *dst, uint32_t *end)
+{
+    uint32_t *burstEnd = dst + ((end - dst) & ~3);
+    register uint32_t zero0 asm("r3") = 0, zero1 asm("r4") = 0, zero2 asm("r5") = 0, zero3 asm("r6") = 0;
+    asm volatile (
+        "   cmp %[dst], %[burstEnd]     \n"
+        "   beq 2f                      \n"
+        "1: stmia %[dst]!, {r3-r6}      \n"
+        "   cmp %[dst], %[burstEnd]     \n"
+        "   bne 1b                      \n"
+        "2:                             \n"
+        : [dst] "+l"(dst)
+        : [burstEnd] "l"(burstEnd), "l"(zero0), "l"(zero1), "l"(zero2), "l"(zero3)
+        : "cc", "memory");
+    while (dst < end) // Remaining 0 - 3 words
+        *dst++ = 0;
+}
+#endif
+
 void resetHandler()
 {
+    bootTrace(BOOT_TRACE_RESET_HANDLER, BOOT_TRACE_ROSC);
+
+#ifdef STARTUP_CYCLES
+    SYST_RVR = 0xffffff; // Count down from the largest value
+    SYST_CVR = 0; // Clear current value, it is reloaded on the first tick
+    SYST_CSR = (1 << 2) | (1 << 0); // Count processor clock cycles, no interrupt
+#endif
+
+#ifdef STARTUP_LIBGLOSS
     // Copy .data section from FLASH to SRAM
     uint32_t *initValsPtr = &_sdataf;
     for (uint32_t *dataPtr = &_sdata; dataPtr < &_edata; ++dataPtr)
         *dataPtr = *initValsPtr++;
-    
+#else
+    // Copy .data section from FLASH to SRAM and zero .bss
+    copyWords(&_sdata, &_edata, &_sdataf);
+    zeroWords(&__bss_start__, &__bss_end__);
+#endif
+    bootTrace(BOOT_TRACE_DATA_INIT, BOOT_TRACE_ROSC);
+
+    irqInit(); // Move the vector table to SRAM, exception entry no longer waits on XIP
+
     // Initialize the system
+#ifdef STARTUP_CYCLES
+    SYST_CSR &= ~(1 << 0); // Pause the count while waiting on XOSC and PLL
+    SystemInit();
+    SYST_CSR |= (1 << 0);
+#else
     SystemInit();
+#endif
+
+    // Objects placed with XIP_SRAM need the cache turned into SRAM before anything, constructors included, uses them
+    if (&__xip_sram_start < &__xip_sram_end) // GCC folds != between two distinct objects to true
+    {
+        xipCacheDisable();
+        for (uint32_t *ptr = &__xip_sram_start; ptr < &__xip_sram_end; ++ptr)
+            *ptr = 0;
+    }
 
+#ifdef STARTUP_LIBGLOSS
+    bootTrace(BOOT_TRACE_MAIN, BOOT_TRACE_TIMER); // libgloss runs the constructors itself
     _start(); // Call C Runtime Startup, it will jump to main function
+#else
+    // Run C++ static constructors and functions marked __attribute__((constructor))
+    for (initFunc *func = __preinit_array_start; func < __preinit_array_end; ++func)
+        (*func)();
+    for (initFunc *func = __init_array_start; func < __init_array_end; ++func)
+        (*func)();
+
+    bootTrace(BOOT_TRACE_MAIN, BOOT_TRACE_TIMER);
+    main();
+#endif
     while(true); // Inf loop if we ever come back here
 }
 
@@ -134,14 +263,14 @@ void resetHandler()
 
 void defaultHandler()
 {
-    RESETS_RESET &= ~(1 << 5); // Bring IO_BANK0 out of reset state
+    regClear(&RESETS_RESET, 1 << 5); // Bring IO_BANK0 out of reset state
     while (!(RESETS_RESET_DONE & (1 << 5))); // Wait for peripheral to respond
     IO_BANK0_GPIO25_CTRL = 5; // Set GPIO 25 function to SIO
-    SIO_GPIO_OE_SET |= 1 << 25; // Set output enable for GPIO 25 in SIO
+    SIO_GPIO_OE_SET = 1 << 25; // Set output enable for GPIO 25 in SIO
 
     while (true)
     {
         usSleep(50000); // Wait for 0.05sec
-        SIO_GPIO_OUT_XOR |= 1 << 25; // Flip output for GPIO 25
+        SIO_GPIO_OUT_XOR = 1 << 25; // Flip output for GPIO 25
     }
 }
\ No newline at end of file
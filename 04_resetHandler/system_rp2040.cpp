@@ -0,0 +1,90 @@
+#include <stdint.h>
+
+#include "bootTrace.h"
+#include "clockTree.h"
+#include "regs_rp2040.h"
+
+using namespace regs;
+
+// Define constants related to clocks, XOSC_HZ and CLK_SYS_HZ can be overridden from the Makefile
+#ifndef XOSC_HZ
+#define XOSC_HZ         (12000000)  // Crystal Oscillator Frequency
+#endif
+#ifndef CLK_SYS_HZ
+#define CLK_SYS_HZ      (100000000) // System Clock Frequency
+#endif
+#define CLK_USB_HZ      (48000000)  // USB and ADC Clock Frequency
+
+// PLL dividers, solved at compile time
+constexpr clockTree::pllConfig pllSys = clockTree::solvePll(XOSC_HZ, CLK_SYS_HZ);
+constexpr clockTree::pllConfig pllUsb = clockTree::solvePll(XOSC_HZ, CLK_USB_HZ);
+static_assert(pllSys.valid, "No PLL_SYS dividers give exactly CLK_SYS_HZ from XOSC_HZ");
+static_assert(pllUsb.valid, "No PLL_USB dividers give exactly 48MHz from XOSC_HZ");
+static_assert(XOSC_HZ % 1000000 == 0, "WATCHDOG_TICK needs XOSC_HZ to be a whole number of MHz");
+
+// Declare flashTimingSetup function
+extern "C" void flashTimingSetup(uint32_t clkSys);
+
+// Bring a PLL out of reset and lock it to the given dividers, the post dividers are left off
+template <typename pllBlock>
+static void pllStart(const pllBlock &block, uint32_t resetBits, const clockTree::pllConfig &config)
+{
+    resets::unreset(resetBits); // Bring PLL out of reset state and wait for it to respond
+    block.cs.write(pll::csRefDiv(config.refDiv)); // Set reference clock div
+    block.fbDivInt.write(config.fbDiv); // Set feedback clock div, thus VCO clock = XOSC / REFDIV * FBDIV
+    block.pwr.clear(pll::pwrPd | pll::pwrVcoPd); // Turn on the main power and VCO
+    block.cs.waitSet(pll::csLock); // Wait for PLL to lock
+}
+
+// Set the post dividers and turn them on, thus the output clock = VCO clock / POSTDIV1 / POSTDIV2
+template <typename pllBlock>
+static void pllEnableOutput(const pllBlock &block, const clockTree::pllConfig &config)
+{
+    block.prim.write(pll::primPostDiv1(config.postDiv1) | pll::primPostDiv2(config.postDiv2));
+    block.pwr.clear(pll::pwrPostDivPd); // Turn on the post dividers
+}
+
+extern "C" void SystemInit()
+{
+    // Initialize XOSC
+    xosc::ctrl.write(xosc::freqRange1To15MHz); // This is needed, otherwise the XOSC doesn't enable properly in the next power cycle.
+    xosc::ctrl.set(xosc::ctrlEnable(xosc::enableMagic)); // Enable XOSC
+    xosc::status.waitSet(xosc::statusStable); // Wait for XOSC to stabilize
+    bootTrace(BOOT_TRACE_XOSC_STABLE, BOOT_TRACE_ROSC);
+
+    // Initialize System PLL
+    pllStart(pll::sys, resets::pllSys, pllSys);
+    bootTrace(BOOT_TRACE_PLL_LOCKED, BOOT_TRACE_ROSC);
+    pllEnableOutput(pll::sys, pllSys);
+
+    // Initialize USB PLL, it feeds clk_usb and clk_adc
+    pllStart(pll::usb, resets::pllUsb, pllUsb);
+    pllEnableOutput(pll::usb, pllUsb);
+
+    // Setup clock generators
+    // Setup clk_ref
+    clocks::refCtrl.set(clocks::ctrlSrc(clocks::refSrcXosc)); // Switch clk_ref glitchless mux to XOSC_CLKSRC for the best accuracy possible
+    clocks::refSelected.waitSet(1 << clocks::refSrcXosc); // Make sure that the switch happened
+    bootTrace(BOOT_TRACE_CLK_REF_SWITCHED, BOOT_TRACE_ROSC);
+    // Setup clk_sys
+    clocks::sysCtrl.set(clocks::ctrlSrc(clocks::sysSrcAux)); // Switch clk_sys glitchless mux to CLKSRC_CLK_SYS_AUX and the aux defaults to CLKSRC_PLL_SYS
+    clocks::sysSelected.waitSet(1 << clocks::sysSrcAux); // Make sure that the switch happened
+    bootTrace(BOOT_TRACE_CLK_SYS_SWITCHED, BOOT_TRACE_CLK_SYS);
+    // Setup clk_peri, clk_usb and clk_adc, the aux mux may only be changed while a generator is disabled
+    clocks::periCtrl.write(clocks::ctrlEnable | clocks::ctrlAuxSrc(clocks::periAuxSrcClkSys)); // Enable clk_peri with CLKSRC_CLK_SYS as source
+    clocks::usbCtrl.write(clocks::ctrlEnable | clocks::ctrlAuxSrc(clocks::usbAuxSrcPllUsb)); // Enable clk_usb with CLKSRC_PLL_USB as source, divider defaults to 1
+    clocks::adcCtrl.write(clocks::ctrlEnable | clocks::ctrlAuxSrc(clocks::usbAuxSrcPllUsb)); // Enable clk_adc with CLKSRC_PLL_USB as source, divider defaults to 1
+
+    // Retune XIP for the new clk_sys, boot2 set up the SSI for the much slower ROSC
+    flashTimingSetup(CLK_SYS_HZ);
+    bootTrace(BOOT_TRACE_FLASH_RETUNED, BOOT_TRACE_CLK_SYS);
+
+    // Shut down ROSC
+    rosc::ctrl.modify(rosc::ctrlEnable, rosc::disableMagic);
+
+    // Enable 64-bit Timer
+    watchdog::tick.set(watchdog::tickCycles(XOSC_HZ / 1000000)); // Set appropriate value for TICK, 1 us = XOSC_HZ / 1MHz cycles
+    resets::unreset(resets::timer); // Bring 64-bit Timer out of reset state and wait for it to respond
+    bootTrace(BOOT_TRACE_TIMER_STARTED, BOOT_TRACE_CLK_SYS);
+    bootTrace(BOOT_TRACE_TIMER_STARTED, BOOT_TRACE_TIMER);
+}
@@ -0,0 +1,162 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "multicore_rp2040.h"
+#include "spinlock_rp2040.h"
+#include "taskPool_rp2040.h"
+
+typedef struct
+{
+    taskFunc func;
+    void *arg;
+    taskCounter *counter;
+} task;
+
+// The owning core pushes and pops at bottom, the other core steals at top. top and bottom run freely and wrap.
+// The M0+ has no LDREX/STREX to build a lock-free deque on, so both ends only move under the deque's SIO spinlock.
+typedef struct
+{
+    uint32_t top;
+    uint32_t bottom;
+    task tasks[TASK_POOL_CAPACITY];
+} taskDeque;
+
+static taskDeque deques[2];
+
+// Chunk of a parallelFor, lives on the stack of the caller until the chunks are done
+typedef struct
+{
+    rangeFunc func;
+    void *arg;
+    uint32_t begin, end;
+} rangeTask;
+
+// Run one task, returns false if neither deque had one
+static bool taskRunOne(uint32_t core)
+{
+    task t;
+    bool found = false;
+
+    taskDeque *deque = &deques[core];
+    uint32_t primask = spinLock(SPINLOCK_TASK_DEQUE(core));
+    if (deque->bottom != deque->top)
+    {
+        t = deque->tasks[--deque->bottom & (TASK_POOL_CAPACITY - 1)]; // Newest first, its data is likely still warm
+        found = true;
+    }
+    spinUnlock(SPINLOCK_TASK_DEQUE(core), primask);
+
+    if (!found)
+    {
+        deque = &deques[core ^ 1];
+        primask = spinLock(SPINLOCK_TASK_DEQUE(core ^ 1));
+        if (deque->bottom != deque->top)
+        {
+            t = deque->tasks[deque->top++ & (TASK_POOL_CAPACITY - 1)]; // Oldest first, usually the largest piece of work left
+            found = true;
+        }
+        spinUnlock(SPINLOCK_TASK_DEQUE(core ^ 1), primask);
+    }
+    if (!found)
+        return false;
+
+    t.func(t.arg);
+    if (t.counter)
+    {
+        primask = spinLock(SPINLOCK_TASK_COUNTER);
+        --t.counter->pending;
+        spinUnlock(SPINLOCK_TASK_COUNTER, primask);
+    }
+    asm volatile ("sev"); // Wake a core waiting on the counter
+    return true;
+}
+
+// Core1 main loop, sleeps in WFE until core0 submits or finishes something
+static void taskWorker(void)
+{
+    while (true)
+    {
+        if (!taskRunOne(1))
+            asm volatile ("wfe");
+    }
+}
+
+void taskPoolStart(void)
+{
+    // The SIO is not reset along with the cores, a lock may still be held from before a warm reset
+    SIO_SPINLOCK(SPINLOCK_TASK_DEQUE(0)) = 0;
+    SIO_SPINLOCK(SPINLOCK_TASK_DEQUE(1)) = 0;
+    SIO_SPINLOCK(SPINLOCK_TASK_COUNTER) = 0;
+    core1Launch(taskWorker);
+}
+
+bool taskSubmit(taskFunc func, void *arg, taskCounter *counter)
+{
+    uint32_t core = coreNum();
+    taskDeque *deque = &deques[core];
+
+    uint32_t primask = spinLock(SPINLOCK_TASK_DEQUE(core));
+    bool full = (deque->bottom - deque->top) == TASK_POOL_CAPACITY;
+    if (!full)
+    {
+        // Counted before it is visible, so the counter never reaches zero early
+        if (counter)
+        {
+            uint32_t counterPrimask = spinLock(SPINLOCK_TASK_COUNTER);
+            ++counter->pending;
+            spinUnlock(SPINLOCK_TASK_COUNTER, counterPrimask);
+        }
+        deque->tasks[deque->bottom & (TASK_POOL_CAPACITY - 1)] = (task){func, arg, counter};
+        ++deque->bottom;
+    }
+    spinUnlock(SPINLOCK_TASK_DEQUE(core), primask);
+
+    if (full)
+        return false;
+    asm volatile ("sev"); // Wake the other core to steal
+    return true;
+}
+
+void taskWait(taskCounter *counter)
+{
+    uint32_t core = coreNum();
+    while (counter->pending)
+    {
+        // A missed SEV is not lost, it stays latched in the event register and the WFE returns right away
+        if (!taskRunOne(core))
+            asm volatile ("wfe");
+    }
+}
+
+static void rangeRun(void *arg)
+{
+    rangeTask *range = (rangeTask *)arg;
+    range->func(range->begin, range->end, range->arg);
+}
+
+void parallelFor(uint32_t begin, uint32_t end, uint32_t grain, rangeFunc func, void *arg)
+{
+    if (end <= begin)
+        return;
+    uint32_t count = end - begin;
+    if (!grain)
+        grain = 1;
+
+    // Even chunks, at most as many as a deque holds
+    uint32_t chunks = count / grain + (count % grain != 0);
+    if (chunks > TASK_POOL_CAPACITY)
+        chunks = TASK_POOL_CAPACITY;
+    uint32_t size = count / chunks, extra = count % chunks;
+
+    rangeTask ranges[TASK_POOL_CAPACITY];
+    taskCounter counter = {0};
+    for (uint32_t i = 0; i < chunks; ++i)
+    {
+        uint32_t stop = begin + size + (i < extra);
+        ranges[i] = (rangeTask){func, arg, begin, stop};
+        if (!taskSubmit(rangeRun, &ranges[i], &counter))
+            func(begin, stop, arg); // Deque full, e.g. a nested parallelFor, run the chunk right here
+        begin = stop;
+    }
+    taskWait(&counter);
+}
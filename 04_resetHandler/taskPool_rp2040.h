@@ -0,0 +1,39 @@
+#ifndef TASK_POOL_RP2040_H
+#define TASK_POOL_RP2040_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Tasks each core's deque holds, a power of two
+#define TASK_POOL_CAPACITY          (32)
+
+typedef void (*taskFunc)(void *arg);
+typedef void (*rangeFunc)(uint32_t begin, uint32_t end, void *arg);
+
+// Counts the tasks of a group that have not finished yet. Zero it before first use.
+typedef struct
+{
+    volatile uint32_t pending;
+} taskCounter;
+
+// Launch core1 as a worker, from core0 only. Afterwards either core may submit and wait.
+void taskPoolStart(void);
+
+// Push a task onto the deque of the calling core, counter may be NULL. Returns false if the deque is full.
+bool taskSubmit(taskFunc func, void *arg, taskCounter *counter);
+
+// Run tasks, own ones newest first and then ones stolen from the other core oldest first, until counter is zero
+void taskWait(taskCounter *counter);
+
+// Call func over [begin, end) split into chunks of at least grain indices, spread over both cores. Returns when all are done.
+void parallelFor(uint32_t begin, uint32_t end, uint32_t grain, rangeFunc func, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,284 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "irq_rp2040.h"
+#include "sections.h"
+#include "regs_rp2040.h"
+#include "timer_rp2040.h"
+
+// Define necessary register addresses
+// TIMER
+#define TIMER_BASE                  (0x40054000)
+#define TIMER_ALARM(n)              (*(volatile uint32_t *) (TIMER_BASE + 0x010 + 4 * (n)))
+#define TIMER_ARMED                 (*(volatile uint32_t *) (TIMER_BASE + 0x020))
+#define TIMER_TIMERAWH              (*(volatile uint32_t *) (TIMER_BASE + 0x024))
+#define TIMER_TIMERAWL              (*(volatile uint32_t *) (TIMER_BASE + 0x028))
+#define TIMER_INTR                  (*(volatile uint32_t *) (TIMER_BASE + 0x034))
+#define TIMER_INTE                  (*(volatile uint32_t *) (TIMER_BASE + 0x038))
+#define TIMER_INTF                  (*(volatile uint32_t *) (TIMER_BASE + 0x03c))
+// NVIC
+#define NVIC_ISER                   (*(volatile uint32_t *) (0xe000e100))
+
+// Timer wheel geometry, 32 slots of 1024us each so one turn covers ~32ms
+#define WHEEL_SLOTS                 (32)
+#define WHEEL_SHIFT                 (10)
+
+// Furthest an alarm is programmed ahead, it compares against the low 32 bits of the counter only
+#define ALARM_MAX_STEP              (0x7fffffff)
+
+// State of a hardware alarm
+typedef struct
+{
+    uint64_t target;            // Absolute time in us
+    timerCallback callback;     // NULL while disarmed
+    void *arg;
+} alarmState;
+
+static alarmState alarms[4];
+
+static swTimer *wheel[WHEEL_SLOTS];     // Unsorted list of timers per slot
+static swTimer *expiredList;            // Timers whose callback is about to run, slot is WHEEL_SLOTS
+static uint32_t wheelUsed;              // Bit n is set while slot n is not empty
+static uint64_t wheelTick;              // Last tick (time >> WHEEL_SHIFT) the wheel was serviced for
+static uint64_t wheelArmed = UINT64_MAX; // Deadline ALARM0 is currently programmed for
+
+// TIMELR/TIMEHR latch on read and would break if an interrupt reads the time in between,
+// so read the raw registers and retry if the high word changed.
+TIME_CRITICAL uint64_t readTime()
+{
+    uint32_t timeHR, timeLR;
+    do
+    {
+        timeHR = TIMER_TIMERAWH;
+        timeLR = TIMER_TIMERAWL;
+    } while (timeHR != TIMER_TIMERAWH);
+    return (((uint64_t)timeHR << 32) | timeLR);
+}
+
+// Program the hardware for the target of an alarm, must be called with interrupts masked
+static void alarmProgram(uint32_t alarm)
+{
+    uint64_t target = alarms[alarm].target;
+    uint64_t now = readTime();
+    if (target > now + ALARM_MAX_STEP)
+        target = now + ALARM_MAX_STEP; // Far targets are reached in steps, see alarmIrq
+
+    TIMER_ALARM(alarm) = (uint32_t)target; // Writing the alarm also arms it
+    // The alarm only fires on an exact match of the low 32 bits. If the target passed before it was armed,
+    // it would wait for the counter to wrap, so disarm it and force the interrupt instead.
+    if (readTime() >= target)
+    {
+        TIMER_ARMED = 1 << alarm;
+        regSet(&TIMER_INTF, 1 << alarm);
+    }
+}
+
+void alarmSet(uint32_t alarm, uint64_t time, timerCallback callback, void *arg)
+{
+    uint32_t primask = irqSave();
+    alarms[alarm].target = time;
+    alarms[alarm].callback = callback;
+    alarms[alarm].arg = arg;
+    regSet(&TIMER_INTE, 1 << alarm);
+    NVIC_ISER = 1 << alarm; // TIMER_IRQ_n is interrupt n
+    alarmProgram(alarm);
+    irqRestore(primask);
+}
+
+void alarmCancel(uint32_t alarm)
+{
+    uint32_t primask = irqSave();
+    alarms[alarm].callback = 0;
+    TIMER_ARMED = 1 << alarm; // Disarm
+    regClear(&TIMER_INTF, 1 << alarm);
+    TIMER_INTR = 1 << alarm; // Drop a match that is already pending
+    irqRestore(primask);
+}
+
+static void alarmIrq(uint32_t alarm)
+{
+    regClear(&TIMER_INTF, 1 << alarm); // Drop a forced interrupt
+    TIMER_INTR = 1 << alarm; // Clear the alarm interrupt
+
+    timerCallback callback = alarms[alarm].callback;
+    if (!callback)
+        return;
+    if (readTime() < alarms[alarm].target)
+    {
+        alarmProgram(alarm); // Intermediate step towards a target more than ALARM_MAX_STEP away
+        return;
+    }
+    alarms[alarm].callback = 0;
+    callback(alarms[alarm].arg);
+}
+
+TIME_CRITICAL void timerIrq0() { alarmIrq(0); }
+TIME_CRITICAL void timerIrq1() { alarmIrq(1); }
+TIME_CRITICAL void timerIrq2() { alarmIrq(2); }
+TIME_CRITICAL void timerIrq3() { alarmIrq(3); }
+
+static void wheelService(void *arg);
+
+// Point ALARM0 at the earliest deadline in the current turn of the wheel, must be called with interrupts masked
+static void wheelArm(void)
+{
+    if (!wheelUsed)
+    {
+        wheelArmed = UINT64_MAX;
+        alarmCancel(0);
+        return;
+    }
+
+    // Slots hold timers of later turns too, only those due in the slot's own tick count
+    uint64_t next = UINT64_MAX;
+    for (uint32_t i = 0; i < WHEEL_SLOTS && next == UINT64_MAX; ++i)
+    {
+        uint64_t tick = wheelTick + i;
+        uint32_t slot = tick & (WHEEL_SLOTS - 1);
+        if (!(wheelUsed & (1 << slot)))
+            continue;
+        for (swTimer *timer = wheel[slot]; timer; timer = timer->next)
+        {
+            if ((timer->deadline >> WHEEL_SHIFT) <= tick && timer->deadline < next)
+                next = timer->deadline;
+        }
+    }
+    if (next == UINT64_MAX)
+        next = (wheelTick + WHEEL_SLOTS) << WHEEL_SHIFT; // Everything is at least a turn away, look again then
+
+    wheelArmed = next;
+    alarmSet(0, next, wheelService, 0);
+}
+
+// Timer lists are singly linked forwards with a back link to whatever points at the timer, so unlinking is O(1)
+static void listPush(swTimer **head, swTimer *timer)
+{
+    timer->next = *head;
+    if (timer->next)
+        timer->next->pprev = &timer->next;
+    timer->pprev = head;
+    *head = timer;
+}
+
+static void listUnlink(swTimer *timer)
+{
+    *timer->pprev = timer->next;
+    if (timer->next)
+        timer->next->pprev = timer->pprev;
+    timer->pprev = 0;
+    if (timer->slot < WHEEL_SLOTS && !wheel[timer->slot])
+        wheelUsed &= ~(1 << timer->slot);
+}
+
+// ALARM0 callback, expires the due timers of every slot passed since the last run
+static void wheelService(void *arg)
+{
+    (void)arg;
+    uint32_t primask = irqSave();
+    uint64_t now = readTime();
+    uint64_t nowTick = now >> WHEEL_SHIFT;
+    uint64_t tick = wheelTick;
+    if (nowTick - tick >= WHEEL_SLOTS)
+        tick = nowTick - (WHEEL_SLOTS - 1); // A full turn or more has passed, every slot is visited once
+
+    for (; tick <= nowTick; ++tick)
+    {
+        swTimer *timer = wheel[tick & (WHEEL_SLOTS - 1)];
+        while (timer)
+        {
+            swTimer *next = timer->next;
+            if (timer->deadline <= now)
+            {
+                listUnlink(timer);
+                timer->slot = WHEEL_SLOTS;
+                listPush(&expiredList, timer);
+            }
+            timer = next;
+        }
+    }
+    wheelTick = nowTick;
+
+    // Callbacks run with interrupts enabled and may start or cancel any timer, including ones still on expiredList
+    while (expiredList)
+    {
+        swTimer *timer = expiredList;
+        listUnlink(timer);
+        irqRestore(primask);
+        timer->callback(timer->arg);
+        primask = irqSave();
+    }
+
+    wheelArm();
+    irqRestore(primask);
+}
+
+void swTimerStart(swTimer *timer, uint64_t deadline, timerCallback callback, void *arg)
+{
+    uint32_t primask = irqSave();
+    if (timer->pprev)
+        swTimerCancel(timer); // Restart
+
+    if (!wheelUsed)
+        wheelTick = readTime() >> WHEEL_SHIFT;
+
+    // A deadline behind the wheel goes into the slot serviced next, it then expires right away
+    uint64_t tick = deadline >> WHEEL_SHIFT;
+    if (tick < wheelTick)
+        tick = wheelTick;
+    uint32_t slot = tick & (WHEEL_SLOTS - 1);
+
+    timer->deadline = deadline;
+    timer->slot = slot;
+    timer->callback = callback;
+    timer->arg = arg;
+    listPush(&wheel[slot], timer);
+    wheelUsed |= 1 << slot;
+
+    if (deadline < wheelArmed)
+    {
+        wheelArmed = deadline;
+        alarmSet(0, deadline, wheelService, 0);
+    }
+    irqRestore(primask);
+}
+
+void swTimerCancel(swTimer *timer)
+{
+    uint32_t primask = irqSave();
+    if (timer->pprev)
+        listUnlink(timer); // ALARM0 stays armed, an early wakeup finds nothing due and rearms for the next deadline
+    irqRestore(primask);
+}
+
+static void sleepWake(void *arg)
+{
+    *(volatile bool *)arg = true;
+}
+
+void usSleep(uint64_t us)
+{
+    uint32_t ipsr, primask;
+    asm volatile ("mrs %0, ipsr" : "=r"(ipsr));
+    asm volatile ("mrs %0, primask" : "=r"(primask));
+
+    // A handler, e.g. defaultHandler, or masked interrupts would never see the alarm, so spin instead
+    if (ipsr || primask)
+    {
+        uint64_t timeOld = readTime(); // Get current timer value
+        while ((readTime() - timeOld) < us); // Wait till desired time is passed
+        return;
+    }
+
+    volatile bool done = false;
+    swTimer timer = {0};
+    swTimerStart(&timer, readTime() + us, sleepWake, (void *)&done);
+    // Check and sleep with interrupts masked. An alarm that fires between the check and the WFI then stays pending
+    // and WFI returns at once, instead of sleeping until some unrelated interrupt. Unmasking lets the handler run.
+    asm volatile ("cpsid i" ::: "memory");
+    while (!done)
+    {
+        asm volatile ("wfi"); // Sleep until an interrupt, any of them, is pending
+        asm volatile ("cpsie i\n isb\n cpsid i" ::: "memory");
+    }
+    asm volatile ("cpsie i" ::: "memory");
+}
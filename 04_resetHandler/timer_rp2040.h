@@ -0,0 +1,48 @@
+#ifndef TIMER_RP2040_H
+#define TIMER_RP2040_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Called from the TIMER interrupt once a deadline is reached
+typedef void (*timerCallback)(void *arg);
+
+// Software timer, owned by the caller and linked into the timer wheel while pending. Zero it before first use.
+typedef struct swTimer
+{
+    struct swTimer *next;       // Next timer in the same wheel slot
+    struct swTimer **pprev;     // Link pointing at this timer, NULL while not pending
+    uint64_t deadline;          // Absolute time in us
+    uint32_t slot;              // Wheel slot the timer is linked into
+    timerCallback callback;
+    void *arg;
+} swTimer;
+
+// Free running 64-bit microsecond counter, safe to call from interrupts
+uint64_t readTime(void);
+
+// Sleep in WFI until the time has passed, busy-waits when called with interrupts masked or from a handler
+void usSleep(uint64_t us);
+
+// One-shot hardware alarm. ALARM0 drives the timer wheel, ALARM1 - ALARM3 are free for exclusive use.
+void alarmSet(uint32_t alarm, uint64_t time, timerCallback callback, void *arg);
+void alarmCancel(uint32_t alarm);
+
+// Any number of timeouts multiplexed onto ALARM0, insert and cancel are O(1)
+void swTimerStart(swTimer *timer, uint64_t deadline, timerCallback callback, void *arg);
+void swTimerCancel(swTimer *timer);
+
+static inline bool swTimerPending(const swTimer *timer)
+{
+    return timer->pprev != 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,112 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include "../bootTrace.h"
+
+// Default clock frequencies for converting SysTick cycles to time
+#define ROSC_HZ         (6500000)   // Nominal, the real ROSC frequency varies from part to part
+#define CLK_SYS_HZ      (100000000)
+
+// Indexed by phase
+static const char *phaseNames[] =
+{
+    "boot2 entry",               // BOOT_TRACE_BOOT2_START
+    "boot2 SSI/XIP setup",       // BOOT_TRACE_BOOT2_XIP
+    "jump to resetHandler",      // BOOT_TRACE_RESET_HANDLER
+    ".data copy, .bss zero",     // BOOT_TRACE_DATA_INIT
+    "XOSC start",                // BOOT_TRACE_XOSC_STABLE
+    "PLL_SYS lock",              // BOOT_TRACE_PLL_LOCKED
+    "clk_ref mux switch",        // BOOT_TRACE_CLK_REF_SWITCHED
+    "clk_sys mux switch",        // BOOT_TRACE_CLK_SYS_SWITCHED
+    "SSI retune",                // BOOT_TRACE_FLASH_RETUNED
+    "ROSC off, TIMER start",     // BOOT_TRACE_TIMER_STARTED
+    "constructors, call main",   // BOOT_TRACE_MAIN
+};
+
+static const char *clockNames[] = {"ROSC", "clk_sys", "TIMER"};
+
+int main(int argc, char *argv[])
+{
+    // Bail if enough arguments are not provided
+    if (argc < 2)
+    {
+        std::cout << "Usage: " << argv[0] << " <dump.bin> [--rosc=<Hz>] [--clk-sys=<Hz>]" << std::endl;
+        std::cout << "The dump is a raw copy of SRAM, or any part of it holding bootTraceBuf. Exiting ..." << std::endl;
+        return 1;
+    }
+
+    double roscHz = ROSC_HZ, clkSysHz = CLK_SYS_HZ;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg.rfind("--rosc=", 0) == 0)
+            roscHz = std::stod(arg.substr(7));
+        else if (arg.rfind("--clk-sys=", 0) == 0)
+            clkSysHz = std::stod(arg.substr(10));
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file)
+    {
+        std::cout << "Could not open file: " << argv[1] << ". Exiting ..." << std::endl;
+        return 1;
+    }
+    std::vector<uint8_t> dump((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // The buffer lives wherever the linker put .noinit, find it by its magic
+    const bootTraceBuffer *buf = nullptr;
+    for (size_t off = 0; off + sizeof(bootTraceBuffer) <= dump.size(); off += 4)
+    {
+        if (*(const uint32_t *)&dump[off] == BOOT_TRACE_MAGIC)
+        {
+            buf = (const bootTraceBuffer *)&dump[off];
+            break;
+        }
+    }
+    if (!buf)
+    {
+        std::cout << "No boot trace found in " << argv[1] << ". Exiting ..." << std::endl;
+        return 1;
+    }
+
+    // Oldest record first, earlier ones were overwritten if the ring wrapped
+    uint32_t first = (buf->count > BOOT_TRACE_SIZE) ? buf->count - BOOT_TRACE_SIZE : 0;
+    if (first)
+        std::cout << "Ring buffer wrapped, the first " << first << " record(s) are lost" << std::endl;
+
+    std::cout << "Phase                        Clock          Stamp     Delta (us)    Total (us)" << std::endl;
+    double total = 0;
+    const bootTraceRecord *prev = nullptr;
+    for (uint32_t i = first; i < buf->count; ++i)
+    {
+        const bootTraceRecord *rec = &buf->records[i & (BOOT_TRACE_SIZE - 1)];
+        uint32_t phase = rec->info & 0xffff, clock = rec->info >> 16;
+
+        // An interval is converted with the clock its starting record was taken with. The same phase recorded
+        // with two clocks back to back only joins the SysTick and TIMER timelines.
+        double delta = 0;
+        if (prev)
+        {
+            uint32_t prevPhase = prev->info & 0xffff, prevClock = prev->info >> 16;
+            if (prevClock == BOOT_TRACE_TIMER && clock == BOOT_TRACE_TIMER)
+                delta = rec->stamp - prev->stamp;
+            else if (prevClock != BOOT_TRACE_TIMER && clock != BOOT_TRACE_TIMER)
+                delta = ((rec->stamp - prev->stamp) & 0xffffff) * 1e6 / (prevClock == BOOT_TRACE_ROSC ? roscHz : clkSysHz);
+            else if (prevPhase != phase)
+                std::cout << "Clock changed without a joining record, the next delta is unknown" << std::endl;
+        }
+        total += delta;
+        prev = rec;
+
+        std::string name = phase < sizeof(phaseNames) / sizeof(phaseNames[0]) ? phaseNames[phase] : "phase " + std::to_string(phase);
+        std::cout << std::left << std::setw(28) << name << " " << std::setw(8) << (clock < 3 ? clockNames[clock] : "?") << std::right
+                  << std::setw(12) << rec->stamp << std::fixed << std::setprecision(2) << std::setw(14) << delta << std::setw(14) << total << std::endl;
+    }
+
+    std::cout << "SysTick converted at ROSC " << roscHz / 1e6 << " MHz and clk_sys " << clkSysHz / 1e6 << " MHz" << std::endl;
+    return 0;
+}
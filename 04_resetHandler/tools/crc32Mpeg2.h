@@ -0,0 +1,63 @@
+#ifndef CRC32_MPEG2_H
+#define CRC32_MPEG2_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// CRC-32/MPEG-2: polynomial 0x04c11db7, initial value 0xffffffff, no reflection and no final XOR.
+// This is what the bootrom checks boot2 against.
+namespace crc32Mpeg2
+{
+    constexpr uint32_t poly = 0x04c11db7;
+    constexpr uint32_t init = 0xffffffff;
+
+    // Slice-by-8 tables, table[k][i] is the CRC of byte i followed by k zero bytes
+    constexpr std::array<std::array<uint32_t, 256>, 8> makeTables()
+    {
+        std::array<std::array<uint32_t, 256>, 8> table{};
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t crc = i << 24;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc & 0x80000000) ? (crc << 1) ^ poly : (crc << 1);
+            table[0][i] = crc;
+        }
+        for (int k = 1; k < 8; ++k)
+        {
+            for (uint32_t i = 0; i < 256; ++i)
+                table[k][i] = (table[k - 1][i] << 8) ^ table[0][table[k - 1][i] >> 24];
+        }
+        return table;
+    }
+
+    inline constexpr auto tables = makeTables();
+
+    constexpr uint32_t update(uint32_t crc, const uint8_t *data, size_t len)
+    {
+        // Eight bytes per step, the CRC is folded into the first four
+        for (; len >= 8; data += 8, len -= 8)
+        {
+            uint32_t hi = crc ^ ((uint32_t)data[0] << 24 | (uint32_t)data[1] << 16 | (uint32_t)data[2] << 8 | data[3]);
+            uint32_t lo = (uint32_t)data[4] << 24 | (uint32_t)data[5] << 16 | (uint32_t)data[6] << 8 | data[7];
+            crc = tables[7][hi >> 24] ^ tables[6][(hi >> 16) & 0xff] ^ tables[5][(hi >> 8) & 0xff] ^ tables[4][hi & 0xff]
+                ^ tables[3][lo >> 24] ^ tables[2][(lo >> 16) & 0xff] ^ tables[1][(lo >> 8) & 0xff] ^ tables[0][lo & 0xff];
+        }
+
+        // Remaining bytes one at a time
+        for (; len; ++data, --len)
+            crc = (crc << 8) ^ tables[0][(crc >> 24) ^ *data];
+        return crc;
+    }
+
+    constexpr uint32_t calculate(const uint8_t *data, size_t len)
+    {
+        return update(init, data, len);
+    }
+
+    // Check value of the CRC catalogue, CRC of the ASCII string "123456789"
+    constexpr uint8_t checkInput[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    static_assert(calculate(checkInput, sizeof(checkInput)) == 0x0376e6e7, "CRC-32/MPEG-2 check value mismatch");
+}
+
+#endif
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#include "elfFile.h"
+
+// UF2 block layout, see https://github.com/microsoft/uf2
+#define UF2_MAGIC_START0        (0x0a324655)
+#define UF2_MAGIC_START1        (0x9e5d5157)
+#define UF2_MAGIC_END           (0x0ab16f30)
+#define UF2_FLAG_FAMILY_ID      (0x00002000)
+#define UF2_BLOCK_SIZE          (512)
+
+// RP2040 specifics
+#define RP2040_FAMILY_ID        (0xe48bff56)
+#define FLASH_START             (0x10000000)
+#define FLASH_END               (0x11000000)
+#define PAGE_SIZE               (256)       // Flash program page, one per UF2 block
+#define SECTOR_SIZE             (4096)      // Flash erase sector
+
+typedef std::array<uint8_t, PAGE_SIZE> page;
+typedef std::map<uint32_t, page> pageMap;
+
+static void put32(uint8_t *dst, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+        dst[i] = (uint8_t)(value >> (8 * i));
+}
+
+static uint32_t get32(const uint8_t *src)
+{
+    return src[0] | (src[1] << 8) | (src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+// Collect the flash pages covered by the loadable segments, gaps between segments are not emitted
+static std::string loadElf(const elfFile &elf, pageMap &pages)
+{
+    for (const elfFile::segment &seg : elf.segments)
+    {
+        if (seg.type != elfFile::PT_LOAD || seg.fileSize == 0)
+            continue;
+        // Segments are placed at their LMA, e.g. .data is stored in flash and copied to SRAM by resetHandler
+        if (seg.paddr < FLASH_START || (uint64_t)seg.paddr + seg.fileSize > FLASH_END)
+        {
+            std::ostringstream err;
+            err << "Loadable segment at 0x" << std::hex << seg.paddr << " is outside of flash";
+            return err.str();
+        }
+        if ((uint64_t)seg.offset + seg.fileSize > elf.data.size())
+            return "Loadable segment extends past the end of the file";
+        for (uint32_t i = 0; i < seg.fileSize; ++i)
+        {
+            uint32_t addr = seg.paddr + i;
+            auto it = pages.find(addr & ~(PAGE_SIZE - 1));
+            if (it == pages.end())
+                it = pages.emplace(addr & ~(PAGE_SIZE - 1), page{}).first;
+            it->second[addr & (PAGE_SIZE - 1)] = elf.data[seg.offset + i];
+        }
+    }
+    return "";
+}
+
+// Collect the flash pages of a previously generated UF2 file, a missing file yields no pages
+static void loadUf2(const std::filesystem::path &path, pageMap &pages)
+{
+    std::ifstream file(path, std::ios::binary);
+    uint8_t block[UF2_BLOCK_SIZE];
+    while (file.read((char *)block, UF2_BLOCK_SIZE))
+    {
+        if (get32(block) != UF2_MAGIC_START0 || get32(block + 4) != UF2_MAGIC_START1 || get32(block + 508) != UF2_MAGIC_END)
+            continue;
+        if (get32(block + 16) != PAGE_SIZE || get32(block + 28) != RP2040_FAMILY_ID)
+            continue;
+        page &p = pages[get32(block + 12)];
+        std::copy(block + 32, block + 32 + PAGE_SIZE, p.begin());
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // Bail if enough arguments are not provided
+    if (argc != 3 && !(argc == 5 && std::string(argv[3]) == "--base"))
+    {
+        std::cout << "Usage: " << argv[0] << " <input.elf> <output.uf2> [--base <flashed.uf2>]" << std::endl;
+        std::cout << "With --base only the flash sectors that differ from <flashed.uf2> are written. Exiting ..." << std::endl;
+        return 1;
+    }
+
+    elfFile elf;
+    std::string err = elf.load(argv[1]);
+    pageMap pages;
+    if (err.empty())
+        err = loadElf(elf, pages);
+    if (!err.empty())
+    {
+        std::cout << err << ". Exiting ..." << std::endl;
+        return 1;
+    }
+
+    // The bootrom erases a whole sector before programming the first page written to it,
+    // so a changed page drags the rest of its sector along with it
+    std::map<uint32_t, bool> sectors;
+    for (const auto &[addr, data] : pages)
+        sectors[addr & ~(SECTOR_SIZE - 1)] = (argc != 5);
+    if (argc == 5)
+    {
+        pageMap basePages;
+        loadUf2(argv[4], basePages);
+        for (const auto &[addr, data] : pages)
+        {
+            auto it = basePages.find(addr);
+            if (it == basePages.end() || it->second != data)
+                sectors[addr & ~(SECTOR_SIZE - 1)] = true;
+        }
+    }
+
+    uint32_t numBlocks = 0;
+    for (const auto &[addr, data] : pages)
+        numBlocks += sectors[addr & ~(SECTOR_SIZE - 1)];
+
+    // Stream the blocks out, one 256 byte flash page per 512 byte UF2 block
+    std::ofstream uf2File(argv[2], std::ios::binary);
+    uint32_t blockNo = 0;
+    for (const auto &[addr, data] : pages)
+    {
+        if (!sectors[addr & ~(SECTOR_SIZE - 1)])
+            continue;
+        uint8_t block[UF2_BLOCK_SIZE] = {0};
+        put32(block + 0, UF2_MAGIC_START0);
+        put32(block + 4, UF2_MAGIC_START1);
+        put32(block + 8, UF2_FLAG_FAMILY_ID);
+        put32(block + 12, addr);
+        put32(block + 16, PAGE_SIZE);
+        put32(block + 20, blockNo++);
+        put32(block + 24, numBlocks);
+        put32(block + 28, RP2040_FAMILY_ID);
+        std::copy(data.begin(), data.end(), block + 32);
+        put32(block + 508, UF2_MAGIC_END);
+        uf2File.write((const char *)block, UF2_BLOCK_SIZE);
+    }
+    uf2File.close();
+    if (!uf2File)
+    {
+        std::cout << "Could not write file: " << argv[2] << ". Exiting ..." << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << numBlocks << " of " << pages.size() << " flash pages to " << argv[2] << std::endl;
+    return 0;
+}
@@ -0,0 +1,140 @@
+#ifndef ELF_FILE_H
+#define ELF_FILE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Minimal reader for the 32-bit little-endian Arm ELF files produced by arm-none-eabi-gcc
+class elfFile
+{
+public:
+    struct section
+    {
+        std::string name;
+        uint32_t type, flags, addr, offset, size, link;
+    };
+
+    struct segment
+    {
+        uint32_t type, offset, vaddr, paddr, fileSize, memSize, flags;
+    };
+
+    struct symbol
+    {
+        std::string name;
+        uint32_t value, size;
+        uint8_t type, bind;
+        uint16_t shndx;
+    };
+
+    static constexpr uint32_t SHT_NOBITS = 8;
+    static constexpr uint32_t SHF_WRITE = 0x1, SHF_ALLOC = 0x2, SHF_EXECINSTR = 0x4;
+    static constexpr uint32_t PT_LOAD = 1;
+    static constexpr uint8_t STT_OBJECT = 1, STT_FUNC = 2;
+
+    std::vector<section> sections;
+    std::vector<segment> segments;
+    std::vector<symbol> symbols;
+    std::vector<uint8_t> data;
+
+    // Load and parse the file, returns an error message or an empty string
+    std::string load(const std::filesystem::path &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return "Could not open file: " + path.string();
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+        // Check the identification bytes: magic, ELFCLASS32, ELFDATA2LSB and EM_ARM
+        if (data.size() < 52 || std::memcmp(data.data(), "\x7f" "ELF", 4) || data[4] != 1 || data[5] != 1 || get16(18) != 40)
+            return path.string() + " is not a 32-bit little-endian Arm ELF file";
+
+        uint32_t phOff = get32(28), shOff = get32(32);
+        uint16_t phEntSize = get16(42), phNum = get16(44), shEntSize = get16(46), shNum = get16(48), shStrNdx = get16(50);
+        if ((uint64_t)phOff + (uint64_t)phEntSize * phNum > data.size() || (uint64_t)shOff + (uint64_t)shEntSize * shNum > data.size() || (shNum && shStrNdx >= shNum))
+            return path.string() + " is truncated";
+
+        for (uint16_t i = 0; i < phNum; ++i)
+        {
+            uint32_t ph = phOff + i * phEntSize;
+            segments.push_back({get32(ph), get32(ph + 4), get32(ph + 8), get32(ph + 12), get32(ph + 16), get32(ph + 20), get32(ph + 24)});
+        }
+
+        std::vector<uint32_t> nameOffsets;
+        for (uint16_t i = 0; i < shNum; ++i)
+        {
+            uint32_t sh = shOff + i * shEntSize;
+            nameOffsets.push_back(get32(sh));
+            sections.push_back({"", get32(sh + 4), get32(sh + 8), get32(sh + 12), get32(sh + 16), get32(sh + 20), get32(sh + 24)});
+        }
+        for (uint16_t i = 0; shNum && i < shNum; ++i)
+            sections[i].name = getString(sections[shStrNdx], nameOffsets[i]);
+
+        // Symbol table is optional, stripped files simply have no symbols
+        for (const section &sec : sections)
+        {
+            if (sec.type != 2 || sec.link >= shNum) // SHT_SYMTAB
+                continue;
+            const section &strTab = sections[sec.link];
+            if ((uint64_t)sec.offset + sec.size > data.size() || (uint64_t)strTab.offset + strTab.size > data.size())
+                return path.string() + " is truncated";
+            for (uint32_t sym = sec.offset + 16; sym + 16 <= sec.offset + sec.size; sym += 16)
+                symbols.push_back({getString(strTab, get32(sym)), get32(sym + 4), get32(sym + 8), (uint8_t)(data[sym + 12] & 0xf), (uint8_t)(data[sym + 12] >> 4), get16(sym + 14)});
+        }
+
+        return "";
+    }
+
+    // Write the (possibly modified) contents back
+    bool save(const std::filesystem::path &path) const
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write((const char *)data.data(), data.size());
+        return (bool)file;
+    }
+
+    const section *findSection(const std::string &name) const
+    {
+        for (const section &sec : sections)
+        {
+            if (sec.name == name)
+                return &sec;
+        }
+        return nullptr;
+    }
+
+    const symbol *findSymbol(const std::string &name) const
+    {
+        for (const symbol &sym : symbols)
+        {
+            if (sym.name == name)
+                return &sym;
+        }
+        return nullptr;
+    }
+
+    uint16_t get16(uint32_t offset) const { return data[offset] | (data[offset + 1] << 8); }
+    uint32_t get32(uint32_t offset) const { return get16(offset) | ((uint32_t)get16(offset + 2) << 16); }
+    void put32(uint32_t offset, uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+            data[offset + i] = (uint8_t)(value >> (8 * i));
+    }
+
+private:
+    std::string getString(const section &strTab, uint32_t offset) const
+    {
+        std::string str;
+        uint64_t end = std::min<uint64_t>((uint64_t)strTab.offset + strTab.size, data.size());
+        for (uint64_t i = (uint64_t)strTab.offset + offset; i < end && data[i]; ++i)
+            str += (char)data[i];
+        return str;
+    }
+};
+
+#endif
@@ -0,0 +1,173 @@
+#include <iostream>
+#include <set>
+
+#include "profileData.h"
+
+// XIP cache geometry, 16kB 2-way set associative with 8 byte lines
+#define CACHE_LINE      (8)
+#define CACHE_WAYS      (2)
+#define CACHE_SETS      (16384 / CACHE_WAYS / CACHE_LINE)
+
+// Functions are packed at their usual Thumb alignment when the new layout is estimated
+#define FUNC_ALIGN      (4)
+
+struct hotFunction
+{
+    const funcTable::function *func;
+    uint64_t samples;
+};
+
+// Cache footprint of a set of address ranges
+struct footprint
+{
+    uint32_t lines = 0;     // Distinct cache lines touched
+    uint32_t span = 0;      // Bytes from the lowest to the highest address
+    uint32_t overSets = 0;  // Sets holding more lines than there are ways, these evict each other
+};
+
+static footprint measure(const std::vector<std::pair<uint32_t, uint32_t>> &ranges)
+{
+    footprint fp;
+    std::set<uint32_t> lines;
+    uint32_t low = UINT32_MAX, high = 0;
+    for (const auto &[start, end] : ranges)
+    {
+        for (uint32_t line = start / CACHE_LINE; line <= (end - 1) / CACHE_LINE; ++line)
+            lines.insert(line);
+        low = std::min(low, start);
+        high = std::max(high, end);
+    }
+    std::vector<uint32_t> perSet(CACHE_SETS);
+    for (uint32_t line : lines)
+        ++perSet[line % CACHE_SETS];
+    fp.lines = lines.size();
+    fp.span = ranges.empty() ? 0 : high - low;
+    fp.overSets = std::count_if(perSet.begin(), perSet.end(), [](uint32_t n) { return n > CACHE_WAYS; });
+    return fp;
+}
+
+// Samples per function from a "<name> <count>" text file, e.g. from a host simulation, # starts a comment
+static std::string loadCounts(const std::filesystem::path &path, std::map<std::string, uint64_t> &counts)
+{
+    std::ifstream file(path);
+    if (!file)
+        return "Could not open file: " + path.string();
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream str(line.substr(0, line.find('#')));
+        std::string name;
+        uint64_t count;
+        if (str >> name >> count)
+            counts[name] += count;
+    }
+    return "";
+}
+
+int main(int argc, char *argv[])
+{
+    // Bail if enough arguments are not provided
+    bool countsFile = argc == 5 && std::string(argv[2]) == "--counts";
+    if (argc != 4 && !countsFile)
+    {
+        std::cout << "Usage: " << argv[0] << " <firmware.elf> [--counts] <profile> <order.ld>" << std::endl;
+        std::cout << "The profile is a RAM dump of a PROFILE_US build, or with --counts a text file of \"<function> <samples>\" lines. Exiting ..." << std::endl;
+        return 1;
+    }
+    const char *profilePath = argv[countsFile ? 3 : 2], *orderPath = argv[countsFile ? 4 : 3];
+
+    elfFile elf;
+    std::string err = elf.load(argv[1]);
+    if (!err.empty())
+    {
+        std::cout << err << ". Exiting ..." << std::endl;
+        return 1;
+    }
+    funcTable funcs(elf);
+    const elfFile::section *text = elf.findSection(".text");
+    const elfFile::symbol *stext = elf.findSymbol("_stext");
+    if (!text || !stext)
+    {
+        std::cout << "No .text section or _stext symbol in " << argv[1] << ". Exiting ..." << std::endl;
+        return 1;
+    }
+
+    std::map<std::string, uint64_t> counts;
+    if (countsFile)
+    {
+        err = loadCounts(profilePath, counts);
+    }
+    else
+    {
+        std::ifstream file(profilePath, std::ios::binary);
+        std::vector<uint8_t> dump((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        const profileBuffer *buf = findProfile(dump);
+        if (!file)
+            err = std::string("Could not open file: ") + profilePath;
+        else if (!buf || !buf->samples)
+            err = std::string("No profile samples found in ") + profilePath;
+        else
+            counts = functionSamples(funcs, *buf);
+    }
+    if (!err.empty())
+    {
+        std::cout << err << ". Exiting ..." << std::endl;
+        return 1;
+    }
+
+    // Only functions in flash .text can be reordered, .time_critical already runs from SRAM and the vector table stays first
+    std::vector<hotFunction> hot;
+    for (const funcTable::function &func : funcs.funcs)
+    {
+        auto it = counts.find(func.name);
+        if (it != counts.end() && it->second && func.start >= stext->value && func.end <= text->addr + text->size)
+            hot.push_back({&func, it->second});
+    }
+    if (hot.empty())
+    {
+        std::cout << "None of the sampled functions are in .text. Exiting ..." << std::endl;
+        return 1;
+    }
+
+    // Densest first, samples per byte, so small hot functions are not pushed out of the cache by a big lukewarm one
+    std::sort(hot.begin(), hot.end(), [](const hotFunction &a, const hotFunction &b)
+    {
+        uint64_t lhs = a.samples * (b.func->end - b.func->start), rhs = b.samples * (a.func->end - a.func->start);
+        return lhs != rhs ? lhs > rhs : a.func->start < b.func->start;
+    });
+
+    // Each function is in .text.<name> with -ffunction-sections, GCC may add a prefix such as .text.startup for main
+    std::ofstream order(orderPath);
+    order << "/* Hot functions first in .text, generated by funcOrder from " << profilePath << " */" << std::endl;
+    for (const hotFunction &h : hot)
+        order << "*(.text." << h.func->name << " .text.*." << h.func->name << ")" << std::endl;
+    order.close();
+    if (!order)
+    {
+        std::cout << "Could not write file: " << orderPath << ". Exiting ..." << std::endl;
+        return 1;
+    }
+
+    // Estimate the footprint of the hot code as laid out now and packed from _stext
+    std::vector<std::pair<uint32_t, uint32_t>> before, after;
+    uint32_t addr = stext->value;
+    uint64_t total = 0;
+    for (const hotFunction &h : hot)
+    {
+        uint32_t size = h.func->end - h.func->start;
+        before.push_back({h.func->start, h.func->end});
+        addr = (addr + FUNC_ALIGN - 1) & ~(FUNC_ALIGN - 1);
+        after.push_back({addr, addr + size});
+        addr += size;
+        total += h.samples;
+    }
+    footprint fpBefore = measure(before), fpAfter = measure(after);
+
+    std::cout << "Wrote " << hot.size() << " hot functions (" << total << " samples) to " << orderPath << std::endl;
+    std::cout << "XIP cache footprint       Before     After" << std::endl;
+    std::cout << "Cache lines          " << std::setw(11) << fpBefore.lines << std::setw(10) << fpAfter.lines << "  of " << CACHE_SETS * CACHE_WAYS << std::endl;
+    std::cout << "Span (Bytes)         " << std::setw(11) << fpBefore.span << std::setw(10) << fpAfter.span << std::endl;
+    std::cout << "Oversubscribed sets  " << std::setw(11) << fpBefore.overSets << std::setw(10) << fpAfter.overSets << std::endl;
+    std::cout << "Relink to apply, sizes of functions that were inlined or grew since profiling are estimates" << std::endl;
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include "../latency.h"
+
+static const char *sourceNames[] = {"NVIC pend", "TIMER alarm", "SIO FIFO"};
+
+// Smallest latency at or below which the given share of the samples lies
+static uint32_t percentile(const latencyResult &result, double share)
+{
+    uint64_t target = (uint64_t)(result.count * share + 0.5), seen = 0;
+    for (uint32_t bin = 0; bin < LATENCY_BINS; ++bin)
+    {
+        seen += result.hist[bin];
+        if (seen >= target && seen)
+            return bin;
+    }
+    return LATENCY_BINS - 1;
+}
+
+int main(int argc, char *argv[])
+{
+    // Bail if enough arguments are not provided
+    if (argc < 2)
+    {
+        std::cout << "Usage: " << argv[0] << " <dump.bin> [--hist]" << std::endl;
+        std::cout << "The dump is a raw copy of SRAM, or any part of it holding latencyBuf. Exiting ..." << std::endl;
+        return 1;
+    }
+    bool showHist = (argc > 2 && std::string(argv[2]) == "--hist");
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file)
+    {
+        std::cout << "Could not open file: " << argv[1] << ". Exiting ..." << std::endl;
+        return 1;
+    }
+    std::vector<uint8_t> dump((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // The buffer lives wherever the linker put .noinit, find it by its magic
+    const latencyBuffer *buf = nullptr;
+    for (size_t off = 0; off + sizeof(latencyBuffer) <= dump.size(); off += 4)
+    {
+        if (*(const uint32_t *)&dump[off] == LATENCY_MAGIC && *(const uint32_t *)&dump[off + 4] == LATENCY_CASES)
+        {
+            buf = (const latencyBuffer *)&dump[off];
+            break;
+        }
+    }
+    if (!buf)
+    {
+        std::cout << "No latency results found in " << argv[1] << ". Exiting ..." << std::endl;
+        return 1;
+    }
+
+    std::cout << "Source       Code   XIP      Runs   Min    Mean   Max   p99  Resolution (cycles)" << std::endl;
+    for (uint32_t source = 0; source < LATENCY_SOURCES; ++source)
+    {
+        for (uint32_t placement = LATENCY_FLASH; placement <= LATENCY_SRAM; ++placement)
+        {
+            for (uint32_t cache = LATENCY_WARM; cache <= LATENCY_COLD; ++cache)
+            {
+                const latencyResult &result = buf->results[LATENCY_CASE(source, placement, cache)];
+                std::cout << std::left << std::setw(12) << sourceNames[source] << " " << std::setw(6) << (placement == LATENCY_FLASH ? "flash" : "SRAM")
+                          << " " << std::setw(5) << (cache == LATENCY_COLD ? "cold" : "warm") << std::right << std::setw(7) << result.count;
+                if (!result.count)
+                {
+                    std::cout << "  no samples" << std::endl;
+                    continue;
+                }
+                std::cout << std::setw(6) << result.min << std::fixed << std::setprecision(1) << std::setw(8) << (double)result.sum / result.count
+                          << std::setw(6) << result.max << std::setw(6) << percentile(result, 0.99) << std::setw(8) << result.resolution;
+                if (result.max >= LATENCY_BINS - 1)
+                    std::cout << "  (histogram clipped at " << LATENCY_BINS - 1 << ")";
+                std::cout << std::endl;
+
+                if (showHist)
+                {
+                    for (uint32_t bin = 0; bin < LATENCY_BINS; ++bin)
+                    {
+                        if (result.hist[bin])
+                            std::cout << std::setw(28) << bin << std::setw(8) << result.hist[bin] << std::endl;
+                    }
+                }
+            }
+        }
+    }
+    std::cout << "Sampled sources see the event up to one resolution late, NVIC pend is exact" << std::endl;
+    return 0;
+}
@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <regex>
+#include <sstream>
+
+#include "elfFile.h"
+
+// Size of boot2 code checked by the bootrom, the CRC32 occupies the last 4 bytes of the 256 byte block
+#define BOOT2_SIZE      (252)
+
+// Region from the MEMORY block of the linker script
+struct region
+{
+    std::string name;
+    uint32_t origin, length;
+    uint32_t used = 0;      // Highest address allocated in the region, relative to its origin
+};
+
+// Allocated section with its run (VMA) and load (LMA) address
+struct placedSection
+{
+    const elfFile::section *sec;
+    uint32_t lma;
+    bool loaded;            // Has contents in the image, i.e. occupies flash at its LMA
+};
+
+// Parse a number as written in a linker script, e.g. 0x10000000, 2048k or 2M
+static uint32_t parseNumber(const std::string &str)
+{
+    size_t end;
+    uint32_t value = std::stoul(str, &end, 0);
+    if (end < str.size() && (str[end] == 'k' || str[end] == 'K'))
+        value *= 1024;
+    else if (end < str.size() && (str[end] == 'm' || str[end] == 'M'))
+        value *= 1024 * 1024;
+    return value;
+}
+
+// Read the regions out of the MEMORY block, returns an error message or an empty string
+static std::string loadRegions(const std::filesystem::path &path, std::vector<region> &regions)
+{
+    std::ifstream file(path);
+    if (!file)
+        return "Could not open file: " + path.string();
+    std::stringstream text;
+    text << file.rdbuf();
+    std::string script = std::regex_replace(text.str(), std::regex("/\\*[\\s\\S]*?\\*/"), " ");
+
+    std::smatch block;
+    if (!std::regex_search(script, block, std::regex("MEMORY\\s*\\{([^}]*)\\}")))
+        return "No MEMORY block found in " + path.string();
+
+    std::regex entry("(\\w+)\\s*(\\([^)]*\\))?\\s*:\\s*ORIGIN\\s*=\\s*(\\w+)\\s*,\\s*LENGTH\\s*=\\s*(\\w+)");
+    std::string body = block[1];
+    for (std::sregex_iterator it(body.begin(), body.end(), entry), end; it != end; ++it)
+        regions.push_back({(*it)[1], parseNumber((*it)[3]), parseNumber((*it)[4])});
+    if (regions.empty())
+        return "MEMORY block in " + path.string() + " is empty";
+    return "";
+}
+
+static region *findRegion(std::vector<region> &regions, uint32_t addr)
+{
+    for (region &reg : regions)
+    {
+        if (addr >= reg.origin && addr - reg.origin < reg.length)
+            return &reg;
+    }
+    return nullptr;
+}
+
+// The stack sections of link.ld only reserve what is left up to __stack and __core1_stack. Their size is the
+// headroom and not usage, it changes with everything else placed in the same region.
+static bool isStackReservation(const std::string &name)
+{
+    return name == ".stack" || name == ".core1_stack";
+}
+
+// Allocated sections in address order, the LMA is taken from the segment holding the section
+static std::vector<placedSection> placeSections(const elfFile &elf)
+{
+    std::vector<placedSection> placed;
+    for (const elfFile::section &sec : elf.sections)
+    {
+        if (!(sec.flags & elfFile::SHF_ALLOC))
+            continue;
+        uint32_t lma = sec.addr;
+        for (const elfFile::segment &seg : elf.segments)
+        {
+            if (seg.type == elfFile::PT_LOAD && sec.addr >= seg.vaddr && sec.addr < seg.vaddr + std::max(seg.memSize, 1u)
+                && sec.offset >= seg.offset && sec.offset <= seg.offset + seg.fileSize)
+            {
+                lma = seg.paddr + (sec.addr - seg.vaddr);
+                break;
+            }
+        }
+        placed.push_back({&sec, lma, sec.type != elfFile::SHT_NOBITS && sec.size != 0});
+    }
+    std::sort(placed.begin(), placed.end(), [](const placedSection &a, const placedSection &b) { return a.sec->addr < b.sec->addr; });
+    return placed;
+}
+
+// Sized functions and objects, summed by name so that a renamed or split function shows up as a change
+static std::map<std::string, uint32_t> symbolSizes(const elfFile &elf)
+{
+    std::map<std::string, uint32_t> sizes;
+    for (const elfFile::symbol &sym : elf.symbols)
+    {
+        if ((sym.type == elfFile::STT_FUNC || sym.type == elfFile::STT_OBJECT) && sym.size)
+            sizes[sym.name] += sym.size;
+    }
+    return sizes;
+}
+
+static std::string hex(uint32_t value)
+{
+    std::ostringstream str;
+    str << "0x" << std::hex << std::setw(8) << std::setfill('0') << value;
+    return str.str();
+}
+
+static std::string signedSize(int64_t value)
+{
+    return (value > 0 ? "+" : "") + std::to_string(value);
+}
+
+static int report(const std::filesystem::path &ldPath, const std::filesystem::path &elfPath)
+{
+    std::vector<region> regions;
+    elfFile elf;
+    std::string err = loadRegions(ldPath, regions);
+    if (err.empty())
+        err = elf.load(elfPath);
+    if (!err.empty())
+    {
+        std::cout << err << ". Exiting ..." << std::endl;
+        return 1;
+    }
+
+    std::vector<placedSection> placed = placeSections(elf);
+    const elfFile::symbol *stack = elf.findSymbol("__stack");
+
+    // Sections, a loaded section whose VMA differs from its LMA (.data) takes up space in two regions
+    std::cout << "Section                 VMA         LMA          Size  Region" << std::endl;
+    for (const placedSection &ps : placed)
+    {
+        region *vmaRegion = findRegion(regions, ps.sec->addr);
+        region *lmaRegion = ps.loaded ? findRegion(regions, ps.lma) : nullptr;
+        std::string where = vmaRegion ? vmaRegion->name : "?";
+        if (lmaRegion && lmaRegion != vmaRegion)
+            where += " (loaded from " + lmaRegion->name + ")";
+        std::cout << std::left << std::setw(22) << ps.sec->name << std::right << "  " << hex(ps.sec->addr) << "  "
+                  << (ps.loaded ? hex(ps.lma) : std::string(10, ' ')) << "  " << std::setw(6) << ps.sec->size << "  " << where << std::endl;
+
+        if (isStackReservation(ps.sec->name))
+            continue;
+        if (vmaRegion && ps.sec->size)
+            vmaRegion->used = std::max(vmaRegion->used, ps.sec->addr + ps.sec->size - vmaRegion->origin);
+        if (lmaRegion && lmaRegion != vmaRegion)
+            lmaRegion->used = std::max(lmaRegion->used, ps.lma + ps.sec->size - lmaRegion->origin);
+    }
+
+    std::cout << std::endl << "Region         Origin        Used      Free    Size" << std::endl;
+    for (const region &reg : regions)
+    {
+        std::cout << std::left << std::setw(10) << reg.name << std::right << "  " << hex(reg.origin) << "  " << std::setw(8) << reg.used
+                  << "  " << std::setw(8) << (int64_t)reg.length - reg.used << "  " << std::setw(6) << reg.length
+                  << "  (" << std::fixed << std::setprecision(1) << 100.0 * reg.used / reg.length << "%)" << std::endl;
+    }
+
+    // Budgets that are not visible from the regions alone
+    std::cout << std::endl;
+    const elfFile::symbol *sBoot2 = elf.findSymbol("_sboot2"), *eBoot2 = elf.findSymbol("_eboot2");
+    if (sBoot2 && eBoot2)
+    {
+        int64_t boot2 = (int64_t)eBoot2->value - sBoot2->value;
+        std::cout << "boot2:        " << boot2 << " of " << BOOT2_SIZE << " Bytes, ";
+        if (boot2 > BOOT2_SIZE)
+            std::cout << boot2 - BOOT2_SIZE << " Bytes OVER budget" << std::endl;
+        else
+            std::cout << BOOT2_SIZE - boot2 << " Bytes free" << std::endl;
+    }
+    const elfFile::symbol *sTimeCritical = elf.findSymbol("_stime_critical"), *eTimeCritical = elf.findSymbol("_etime_critical");
+    if (sTimeCritical && eTimeCritical)
+        std::cout << "SRAM code:    " << eTimeCritical->value - sTimeCritical->value << " Bytes of .time_critical at " << hex(sTimeCritical->value) << std::endl;
+    const elfFile::symbol *vector = elf.findSymbol("vector");
+    if (vector)
+        std::cout << "Vector table: " << vector->size << " Bytes at " << hex(vector->value) << " (" << vector->size / 4 << " entries)" << std::endl;
+    if (stack)
+    {
+        region *sram = findRegion(regions, stack->value - 1);
+        uint32_t top = 0;
+        for (const placedSection &ps : placed)
+        {
+            if (!isStackReservation(ps.sec->name) && sram && findRegion(regions, ps.sec->addr) == sram)
+                top = std::max(top, ps.sec->addr + ps.sec->size);
+        }
+        if (top)
+            std::cout << "Stack:        " << (int64_t)stack->value - top << " Bytes between " << hex(top) << " and __stack at " << hex(stack->value) << std::endl;
+    }
+
+    // Symbols of each section, largest first
+    for (size_t i = 0; i < elf.sections.size(); ++i)
+    {
+        const elfFile::section &sec = elf.sections[i];
+        std::vector<const elfFile::symbol *> syms;
+        for (const elfFile::symbol &sym : elf.symbols)
+        {
+            if (sym.shndx == i && sym.size && (sym.type == elfFile::STT_FUNC || sym.type == elfFile::STT_OBJECT))
+                syms.push_back(&sym);
+        }
+        if (syms.empty())
+            continue;
+        std::stable_sort(syms.begin(), syms.end(), [](const elfFile::symbol *a, const elfFile::symbol *b) { return a->size > b->size; });
+        std::cout << std::endl << sec.name << std::endl;
+        for (const elfFile::symbol *sym : syms)
+            std::cout << "    " << hex(sym->value & ~1u) << "  " << std::setw(6) << sym->size << "  " << sym->name << std::endl;
+    }
+
+    // Exit code tells the Makefile if anything no longer fits
+    bool over = sBoot2 && eBoot2 && eBoot2->value - sBoot2->value > BOOT2_SIZE;
+    for (const region &reg : regions)
+        over |= reg.used > reg.length;
+    return over ? 1 : 0;
+}
+
+static int diff(const std::filesystem::path &oldPath, const std::filesystem::path &newPath)
+{
+    elfFile oldElf, newElf;
+    std::string err = oldElf.load(oldPath);
+    if (err.empty())
+        err = newElf.load(newPath);
+    if (!err.empty())
+    {
+        std::cout << err << ". Exiting ..." << std::endl;
+        return 1;
+    }
+
+    std::map<std::string, std::pair<uint32_t, uint32_t>> sections;
+    for (const placedSection &ps : placeSections(oldElf))
+        sections[ps.sec->name].first = ps.sec->size;
+    for (const placedSection &ps : placeSections(newElf))
+        sections[ps.sec->name].second = ps.sec->size;
+
+    std::cout << "Section                    Old       New     Delta" << std::endl;
+    for (const auto &[name, size] : sections)
+    {
+        if (!isStackReservation(name) && size.first != size.second)
+            std::cout << std::left << std::setw(22) << name << std::right << std::setw(8) << size.first << "  " << std::setw(8) << size.second
+                      << "  " << std::setw(8) << signedSize((int64_t)size.second - size.first) << std::endl;
+    }
+
+    // Changed symbols, biggest change first
+    std::map<std::string, uint32_t> oldSyms = symbolSizes(oldElf), newSyms = symbolSizes(newElf);
+    std::vector<std::pair<std::string, int64_t>> changes;
+    for (const auto &[name, size] : oldSyms)
+    {
+        auto it = newSyms.find(name);
+        int64_t delta = (int64_t)(it == newSyms.end() ? 0 : it->second) - size;
+        if (delta)
+            changes.push_back({name, delta});
+    }
+    for (const auto &[name, size] : newSyms)
+    {
+        if (!oldSyms.count(name))
+            changes.push_back({name, size});
+    }
+    std::stable_sort(changes.begin(), changes.end(), [](const auto &a, const auto &b) { return std::abs(a.second) > std::abs(b.second); });
+
+    std::cout << std::endl << "Symbol                     Old       New     Delta" << std::endl;
+    int64_t total = 0;
+    for (const auto &[name, delta] : changes)
+    {
+        uint32_t oldSize = oldSyms.count(name) ? oldSyms[name] : 0, newSize = newSyms.count(name) ? newSyms[name] : 0;
+        std::cout << std::left << std::setw(22) << name << std::right << std::setw(8) << oldSize << "  " << std::setw(8) << newSize
+                  << "  " << std::setw(8) << signedSize(delta) << std::endl;
+        total += delta;
+    }
+    std::cout << std::left << std::setw(22) << "Total" << std::right << std::setw(28) << signedSize(total) << std::endl;
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc == 4 && std::string(argv[1]) == "--diff")
+        return diff(argv[2], argv[3]);
+    if (argc == 3)
+        return report(argv[1], argv[2]);
+
+    // Bail if enough arguments are not provided
+    std::cout << "Usage: " << argv[0] << " <link.ld> <input.elf>" << std::endl;
+    std::cout << "       " << argv[0] << " --diff <old.elf> <new.elf>" << std::endl;
+    std::cout << "Exiting ..." << std::endl;
+    return 1;
+}
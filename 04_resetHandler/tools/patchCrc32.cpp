@@ -0,0 +1,62 @@
+#include <iostream>
+#include <iomanip>
+
+#include "crc32Mpeg2.h"
+#include "elfFile.h"
+
+// Size of boot2 code checked by the bootrom, the CRC32 occupies the last 4 bytes of the 256 byte block
+#define BOOT2_SIZE      (252)
+
+int main(int argc, char *argv[])
+{
+    // Bail if enough arguments are not provided
+    if (argc < 2)
+    {
+        std::cout << "An input file with .elf extension must be provided. Exiting ..." << std::endl;
+        return 1;
+    }
+
+    std::filesystem::path elfFilePath = argv[1];
+    elfFile elf;
+    std::string err = elf.load(elfFilePath);
+    if (!err.empty())
+    {
+        std::cout << err << ". Exiting ..." << std::endl;
+        return 1;
+    }
+
+    // Locate the .boot2 output section created by link.ld
+    const elfFile::section *boot2 = elf.findSection(".boot2");
+    if (!boot2)
+    {
+        std::cout << "Could not locate .boot2 section in " << elfFilePath << ". Exiting ..." << std::endl;
+        return 1;
+    }
+
+    // Report by how much boot2 code overshoots its budget, link.ld only pads it and leaves the check to us
+    if (boot2->size > BOOT2_SIZE + 4)
+    {
+        std::cout << "boot2 code is " << boot2->size - 4 << " Bytes, " << boot2->size - 4 - BOOT2_SIZE << " Bytes over the " << BOOT2_SIZE << " Byte budget. Exiting ..." << std::endl;
+        return 1;
+    }
+
+    // Bail if it is not exactly boot2 code plus the CRC32 slot
+    if (boot2->size != BOOT2_SIZE + 4 || boot2->type == elfFile::SHT_NOBITS || boot2->offset + boot2->size > elf.data.size())
+    {
+        std::cout << "The .boot2 section must be " << BOOT2_SIZE + 4 << " Bytes in size, found " << boot2->size << ". Exiting ..." << std::endl;
+        return 1;
+    }
+
+    // Calculate CRC32 for the 252 bytes of data and store it little-endian in the slot after them
+    uint32_t crc = crc32Mpeg2::calculate(&elf.data[boot2->offset], BOOT2_SIZE);
+    elf.put32(boot2->offset + BOOT2_SIZE, crc);
+
+    if (!elf.save(elfFilePath))
+    {
+        std::cout << "Could not write file: " << elfFilePath << ". Exiting ..." << std::endl;
+        return 1;
+    }
+
+    std::cout << "boot2 CRC32 = 0x" << std::setw(8) << std::setfill('0') << std::hex << crc << std::endl;
+    return 0;
+}
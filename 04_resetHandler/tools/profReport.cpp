@@ -0,0 +1,76 @@
+#include <iostream>
+
+#include "profileData.h"
+
+static void printSorted(const std::map<std::string, uint64_t> &counts, uint64_t total)
+{
+    std::vector<std::pair<std::string, uint64_t>> rows(counts.begin(), counts.end());
+    std::sort(rows.begin(), rows.end(), [](const auto &a, const auto &b) { return a.second > b.second; });
+    for (const auto &[name, count] : rows)
+    {
+        std::cout << std::setw(9) << count << std::fixed << std::setprecision(1) << std::setw(7) << 100.0 * count / total << "%  " << name << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // Bail if enough arguments are not provided
+    if (argc != 3)
+    {
+        std::cout << "Usage: " << argv[0] << " <firmware.elf> <dump.bin>" << std::endl;
+        std::cout << "The dump is a raw copy of SRAM, or any part of it holding profileBuf. Exiting ..." << std::endl;
+        return 1;
+    }
+
+    elfFile elf;
+    std::string err = elf.load(argv[1]);
+    if (!err.empty())
+    {
+        std::cout << err << ". Exiting ..." << std::endl;
+        return 1;
+    }
+    funcTable funcs(elf);
+
+    std::ifstream file(argv[2], std::ios::binary);
+    if (!file)
+    {
+        std::cout << "Could not open file: " << argv[2] << ". Exiting ..." << std::endl;
+        return 1;
+    }
+    std::vector<uint8_t> dump((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    const profileBuffer *buf = findProfile(dump);
+    if (!buf || !buf->samples)
+    {
+        std::cout << "No profile samples found in " << argv[2] << ". Exiting ..." << std::endl;
+        return 1;
+    }
+
+    // Flat profile
+    std::map<std::string, uint64_t> flat = functionSamples(funcs, *buf);
+    if (buf->other)
+        flat["(outside .text and .time_critical)"] += buf->other;
+
+    std::cout << "Flat profile, " << buf->samples << " samples, buckets of " << (1u << buf->flashShift) << " Bytes in flash and "
+              << (1u << buf->sramShift) << " Bytes in SRAM" << std::endl;
+    std::cout << "  Samples  Share  Function" << std::endl;
+    printSorted(flat, buf->samples);
+
+    // Call edges, the return address lies just behind the call, so the caller is looked up one byte before it.
+    // A function that has called something else since its own call may have moved LR on, treat edges as hints.
+    std::map<std::string, uint64_t> edges;
+    uint64_t edgeTotal = 0;
+    for (const profileEdge &edge : buf->edges)
+    {
+        if (!edge.count)
+            continue;
+        edges[funcs.name(edge.from - 1) + " -> " + funcs.name(edge.to)] += edge.count;
+        edgeTotal += edge.count;
+    }
+    std::cout << std::endl << "Call edges from the sampled LR, " << edgeTotal << " samples";
+    if (buf->edgesDropped)
+        std::cout << ", " << buf->edgesDropped << " dropped as the table was full";
+    std::cout << std::endl << "  Samples  Share  Caller -> callee" << std::endl;
+    printSorted(edges, edgeTotal ? edgeTotal : 1);
+    return 0;
+}
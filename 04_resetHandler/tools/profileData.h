@@ -0,0 +1,90 @@
+#ifndef PROFILE_DATA_H
+#define PROFILE_DATA_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "elfFile.h"
+#include "../profile_rp2040.h"
+
+// Function symbols of an elf file in address order, for mapping sampled addresses back to functions
+class funcTable
+{
+public:
+    struct function
+    {
+        std::string name;
+        uint32_t start, end;    // Thumb bit cleared
+    };
+
+    std::vector<function> funcs;
+
+    explicit funcTable(const elfFile &elf)
+    {
+        for (const elfFile::symbol &sym : elf.symbols)
+        {
+            if (sym.type == elfFile::STT_FUNC)
+                funcs.push_back({sym.name, sym.value & ~1u, (sym.value & ~1u) + sym.size});
+        }
+        std::sort(funcs.begin(), funcs.end(), [](const function &a, const function &b) { return a.start < b.start; });
+        // A symbol without a size, e.g. from assembly, runs up to the next one
+        for (size_t i = 0; i < funcs.size(); ++i)
+        {
+            if (funcs[i].end == funcs[i].start)
+                funcs[i].end = (i + 1 < funcs.size()) ? funcs[i + 1].start : funcs[i].start + 2;
+        }
+    }
+
+    const function *find(uint32_t addr) const
+    {
+        auto it = std::upper_bound(funcs.begin(), funcs.end(), addr, [](uint32_t a, const function &f) { return a < f.start; });
+        if (it != funcs.begin() && addr < (it - 1)->end)
+            return &*(it - 1);
+        return nullptr;
+    }
+
+    // Function name, or the address if no function covers it
+    std::string name(uint32_t addr) const
+    {
+        if (const function *func = find(addr))
+            return func->name;
+        std::ostringstream str;
+        str << "0x" << std::hex << std::setw(8) << std::setfill('0') << addr;
+        return str.str();
+    }
+};
+
+// Locate profileBuf in a raw SRAM dump by its magic, it lives wherever the linker put .noinit
+inline const profileBuffer *findProfile(const std::vector<uint8_t> &dump)
+{
+    for (size_t off = 0; off + sizeof(profileBuffer) <= dump.size(); off += 4)
+    {
+        if (*(const uint32_t *)&dump[off] == PROFILE_MAGIC)
+            return (const profileBuffer *)&dump[off];
+    }
+    return nullptr;
+}
+
+// Samples per function, a histogram bucket is charged to the function it starts in
+inline std::map<std::string, uint64_t> functionSamples(const funcTable &table, const profileBuffer &buf)
+{
+    std::map<std::string, uint64_t> samples;
+    for (uint32_t i = 0; i < PROFILE_FLASH_BUCKETS; ++i)
+    {
+        if (buf.flash[i])
+            samples[table.name(buf.flashStart + (i << buf.flashShift))] += buf.flash[i];
+    }
+    for (uint32_t i = 0; i < PROFILE_SRAM_BUCKETS; ++i)
+    {
+        if (buf.sram[i])
+            samples[table.name(buf.sramStart + (i << buf.sramShift))] += buf.sram[i];
+    }
+    return samples;
+}
+
+#endif
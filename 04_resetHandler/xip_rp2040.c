@@ -0,0 +1,146 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "dma_rp2040.h"
+#include "irq_rp2040.h"
+#include "regs_rp2040.h"
+#include "xip_rp2040.h"
+
+// Define necessary register addresses
+// XIP aliases, the same flash seen through different cache behavior
+#define XIP_BASE                    (0x10000000)    // Cached, allocating
+#define XIP_NOCACHE_NOALLOC_BASE    (0x13000000)    // Bypasses the cache
+#define XIP_OFFSET_MASK             (0x00ffffff)
+// XIP control
+#define XIP_CTRL_BASE               (0x14000000)
+#define XIP_CTRL                    (*(volatile uint32_t *) (XIP_CTRL_BASE + 0x000))
+#define XIP_FLUSH                   (*(volatile uint32_t *) (XIP_CTRL_BASE + 0x004))
+#define XIP_CTR_HIT                 (*(volatile uint32_t *) (XIP_CTRL_BASE + 0x00c))
+#define XIP_STAT                    (*(volatile uint32_t *) (XIP_CTRL_BASE + 0x008))
+#define XIP_CTR_ACC                 (*(volatile uint32_t *) (XIP_CTRL_BASE + 0x010))
+#define XIP_STREAM_ADDR             (*(volatile uint32_t *) (XIP_CTRL_BASE + 0x014))
+#define XIP_STREAM_CTR              (*(volatile uint32_t *) (XIP_CTRL_BASE + 0x018))
+#define XIP_STREAM_FIFO             (*(volatile uint32_t *) (XIP_CTRL_BASE + 0x01c))
+// Streaming FIFO seen from the fast AHB-Lite port, where DMA reads it without wait states
+#define XIP_AUX_BASE                (0x50400000)
+
+#define XIP_STAT_FIFO_EMPTY         (1 << 1)
+#define XIP_STREAM_CTR_MAX          (0x3fffff)  // Words
+
+static int32_t streamChannel = -1;      // Claimed by the first stream read and kept
+static volatile bool streamBusy;
+static flashStreamCallback streamCallback;
+static void *streamArg;
+
+void xipCountersReset(void)
+{
+    XIP_CTR_HIT = 0; // Any write clears
+    XIP_CTR_ACC = 0;
+}
+
+xipCounters xipCountersRead(void)
+{
+    // Hits first, an access in between then counts towards the accesses only and hits never exceed accesses
+    xipCounters counters;
+    counters.hits = XIP_CTR_HIT;
+    counters.accesses = XIP_CTR_ACC;
+    return counters;
+}
+
+void xipCacheFlush(void)
+{
+    XIP_FLUSH = 1;
+    (void)XIP_FLUSH; // Reading stalls until the flush is done
+}
+
+void xipCachePrefetch(const void *start, uint32_t size)
+{
+    uint32_t offset = (uint32_t)start & XIP_OFFSET_MASK & ~(XIP_CACHE_LINE - 1);
+    uint32_t end = ((uint32_t)start & XIP_OFFSET_MASK) + size;
+    for (; offset < end; offset += XIP_CACHE_LINE)
+        (void)*(volatile uint32_t *)(XIP_BASE + offset);
+}
+
+uint32_t xipCachePin(const void *start, uint32_t size)
+{
+    // A write to the cached alias allocates the line and pins it, the data is kept in the cache and never reaches flash.
+    // Both words of the line are written with what flash holds, read around the cache, so the pinned copy is complete.
+    uint32_t offset = (uint32_t)start & XIP_OFFSET_MASK & ~(XIP_CACHE_LINE - 1);
+    uint32_t end = ((uint32_t)start & XIP_OFFSET_MASK) + size;
+    uint32_t lines = 0;
+    for (; offset < end; offset += XIP_CACHE_LINE, ++lines)
+    {
+        volatile uint32_t *flash = (volatile uint32_t *)(XIP_NOCACHE_NOALLOC_BASE + offset);
+        volatile uint32_t *cache = (volatile uint32_t *)(XIP_BASE + offset);
+        uint32_t word0 = flash[0], word1 = flash[1];
+        cache[0] = word0;
+        cache[1] = word1;
+    }
+    return lines;
+}
+
+void xipCacheDisable(void)
+{
+    regClear(&XIP_CTRL, 1 << 0); // EN, accesses bypass the cache and its memory is free at 0x15000000
+}
+
+void xipCacheEnable(void)
+{
+    xipCacheFlush(); // Whatever was stored as SRAM would otherwise be taken for cached flash
+    regSet(&XIP_CTRL, 1 << 0);
+}
+
+static void streamDone(uint32_t channel, void *arg)
+{
+    (void)channel;
+    (void)arg;
+    streamBusy = false;
+    if (streamCallback)
+        streamCallback(streamArg);
+}
+
+bool flashStreamRead(void *dst, uint32_t flashOffset, uint32_t len, flashStreamCallback callback, void *arg)
+{
+    if (((uint32_t)dst | flashOffset | len) & 3 || len / 4 > XIP_STREAM_CTR_MAX)
+        return false;
+
+    uint32_t primask = irqSave();
+    bool busy = streamBusy;
+    streamBusy = true;
+    irqRestore(primask);
+    if (busy)
+        return false;
+
+    if (streamChannel < 0)
+        streamChannel = dmaClaim();
+    if (streamChannel < 0)
+    {
+        streamBusy = false;
+        return false;
+    }
+
+    if (!len)
+    {
+        streamBusy = false;
+        if (callback)
+            callback(arg);
+        return true;
+    }
+
+    // Leftovers of an earlier stream would be taken for the first words of this one
+    while (!(XIP_STAT & XIP_STAT_FIFO_EMPTY))
+        (void)XIP_STREAM_FIFO;
+
+    streamCallback = callback;
+    streamArg = arg;
+    dmaStart(streamChannel, (const volatile void *)XIP_AUX_BASE, dst, len / 4, DMA_SIZE_WORD | DMA_INCR_WRITE | DMA_TREQ(DREQ_XIP_STREAM),
+             streamDone, 0);
+    XIP_STREAM_ADDR = XIP_NOCACHE_NOALLOC_BASE + (flashOffset & XIP_OFFSET_MASK);
+    XIP_STREAM_CTR = len / 4; // Starts the stream, the FIFO paces the DMA from here
+    return true;
+}
+
+bool flashStreamBusy(void)
+{
+    return streamBusy;
+}
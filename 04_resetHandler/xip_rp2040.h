@@ -0,0 +1,61 @@
+#ifndef XIP_RP2040_H
+#define XIP_RP2040_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// XIP cache geometry, 16kB 2-way set associative with 8 byte lines
+#define XIP_CACHE_SIZE              (16384)
+#define XIP_CACHE_LINE              (8)
+#define XIP_CACHE_WAYS              (2)
+
+// Hit and access counters of the XIP cache. They count the accesses of both cores and DMA alike and saturate.
+typedef struct
+{
+    uint32_t hits;
+    uint32_t accesses;
+} xipCounters;
+
+// Clear the counters, e.g. right before the code region to measure
+void xipCountersReset(void);
+
+// Snapshot of the counters, accesses - hits is the number of flash reads the region caused
+xipCounters xipCountersRead(void);
+
+// Invalidate every line, pinned ones included, and wait for it to finish
+void xipCacheFlush(void);
+
+// Read one word of every line in [start, start + size) through the cached alias, so the code or data there
+// is fetched from flash now and not the first time it is needed. Any XIP alias of the range may be passed.
+void xipCachePrefetch(const void *start, uint32_t size);
+
+// Pin the lines of [start, start + size), they then stay in the cache until the next flush. Only two lines
+// per set can be pinned, lines XIP_CACHE_SIZE / XIP_CACHE_WAYS apart share a set. Returns the lines pinned.
+uint32_t xipCachePin(const void *start, uint32_t size);
+
+// Turn the cache off and use it as 16kB of SRAM at 0x15000000, every flash access goes out over QSPI from then on.
+// resetHandler does this by itself as soon as anything is placed with XIP_SRAM, see sections.h.
+void xipCacheDisable(void);
+
+// Turn the cache back on, the SRAM at 0x15000000 becomes cache again and its content is lost
+void xipCacheEnable(void);
+
+// Called in the DMA interrupt of the calling core once a stream read completed
+typedef void (*flashStreamCallback)(void *arg);
+
+// Copy len bytes from flashOffset on to dst through the XIP streaming FIFO, drained by DMA. The reads go around
+// the cache, so bulk data does not evict code. Returns right away, false if a stream is still running or dst,
+// flashOffset or len are not multiples of 4. Only one stream runs at a time, the hardware has a single one.
+bool flashStreamRead(void *dst, uint32_t flashOffset, uint32_t len, flashStreamCallback callback, void *arg);
+
+bool flashStreamBusy(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif